@@ -19,6 +19,7 @@
  * Mohab Safey El Din */
 
 #include<stdint.h>
+#include<string.h>
 #include <flint/flint.h>
 #include <flint/longlong.h>
 #include <flint/mpn_extras.h>
@@ -63,6 +64,17 @@ typedef struct{
   szmat_t *dense_idx; //position des lignes non triviales (qui constituent donc
                       //dense_mat)
   szmat_t *dst; //pour la gestion des lignes "denses" mais avec un bloc de zero a la fin
+  /* hybrid copy of dense_mat used for the matrix vector products, rebuilt
+     for each prime by build_hybrid_sp_mat_fglm: rows with few non zero
+     entries are stored in CSR format, the other ones stay dense */
+  szmat_t nsp; //nbre de lignes stockees en CSR (0 => on utilise dense_mat)
+  szmat_t *sp_row; //position de ces lignes parmi les nrows lignes non triviales
+  uint64_t *sp_start; //debut de chaque ligne CSR dans sp_col et sp_val
+  szmat_t *sp_col;
+  CF_t *sp_val;
+  szmat_t *hd_row; //position des nrows - nsp lignes restees denses
+  CF_t *hd_mat; //ces lignes, stockees de maniere contigue
+  szmat_t *hd_dst;
 } sp_matfglm_t;
 
 typedef struct{
@@ -122,9 +134,109 @@ typedef struct{
   nmod_poly_t elim;
   nmod_poly_t denom;
   nmod_poly_t *coords;
+  /* when not NULL, coords[i] is not computed if skip[i] != 0 */
+  const int *skip;
 } param_t;
 
 
+/* a row is stored in CSR format when less than 1 / SPARSE_ROW_RATIO of
+   its entries are non zero (a CSR entry costs twice a dense one) */
+#define SPARSE_ROW_RATIO 4
+
+static inline void free_hybrid_sp_mat_fglm(sp_matfglm_t *mat){
+  free(mat->sp_row);
+  free(mat->sp_start);
+  free(mat->sp_col);
+  free(mat->sp_val);
+  free(mat->hd_row);
+  free(mat->hd_mat);
+  free(mat->hd_dst);
+  mat->sp_row = NULL;
+  mat->sp_start = NULL;
+  mat->sp_col = NULL;
+  mat->sp_val = NULL;
+  mat->hd_row = NULL;
+  mat->hd_mat = NULL;
+  mat->hd_dst = NULL;
+  mat->nsp = 0;
+}
+
+/*
+  Splits the non trivial rows of mat into sparse and dense ones.
+  dense_mat is left untouched since it is the buffer in which the matrix
+  is built for each prime.
+  Returns the number of rows stored in CSR format.
+ */
+static inline szmat_t build_hybrid_sp_mat_fglm(sp_matfglm_t *mat){
+  const szmat_t ncols = mat->ncols;
+  const szmat_t nrows = mat->nrows;
+  szmat_t nsp = 0;
+  uint64_t nnz = 0;
+
+  free_hybrid_sp_mat_fglm(mat);
+
+  szmat_t *rlen = malloc(nrows * sizeof(szmat_t));
+  for(szmat_t i = 0; i < nrows; i++){
+    const CF_t *row = mat->dense_mat + (uint64_t)i * ncols;
+    const szmat_t len = ncols - mat->dst[i];
+    szmat_t cnt = 0;
+    for(szmat_t j = 0; j < len; j++){
+      cnt += (row[j] != 0);
+    }
+    rlen[i] = cnt;
+    if((uint64_t)cnt * SPARSE_ROW_RATIO < len){
+      nsp++;
+      nnz += cnt;
+    }
+  }
+  if(nsp == 0){
+    free(rlen);
+    return 0;
+  }
+
+  const szmat_t nhd = nrows - nsp;
+  mat->nsp = nsp;
+  mat->sp_row = malloc(nsp * sizeof(szmat_t));
+  mat->sp_start = malloc((nsp + 1) * sizeof(uint64_t));
+  mat->sp_col = malloc((nnz + 1) * sizeof(szmat_t));
+  mat->sp_val = malloc((nnz + 1) * sizeof(CF_t));
+  mat->hd_row = malloc((nhd + 1) * sizeof(szmat_t));
+  mat->hd_dst = malloc((nhd + 1) * sizeof(szmat_t));
+  if(posix_memalign((void **)&mat->hd_mat, 32,
+                    ((uint64_t)nhd * ncols + 1) * sizeof(CF_t))){
+    fprintf(stderr, "Problem when allocating mat->hd_mat\n");
+    exit(1);
+  }
+
+  szmat_t k = 0, l = 0;
+  uint64_t pos = 0;
+  mat->sp_start[0] = 0;
+  for(szmat_t i = 0; i < nrows; i++){
+    const CF_t *row = mat->dense_mat + (uint64_t)i * ncols;
+    const szmat_t len = ncols - mat->dst[i];
+    if((uint64_t)rlen[i] * SPARSE_ROW_RATIO < len){
+      for(szmat_t j = 0; j < len; j++){
+        if(row[j] != 0){
+          mat->sp_col[pos] = j;
+          mat->sp_val[pos] = row[j];
+          pos++;
+        }
+      }
+      mat->sp_row[k] = i;
+      k++;
+      mat->sp_start[k] = pos;
+    }
+    else{
+      memcpy(mat->hd_mat + (uint64_t)l * ncols, row, ncols * sizeof(CF_t));
+      mat->hd_row[l] = i;
+      mat->hd_dst[l] = mat->dst[i];
+      l++;
+    }
+  }
+  free(rlen);
+  return nsp;
+}
+
 static inline void free_sp_mat_fglm(sp_matfglm_t *mat){
   if(mat!=NULL){
     free(mat->dense_mat);
@@ -132,6 +244,7 @@ static inline void free_sp_mat_fglm(sp_matfglm_t *mat){
     free(mat->triv_pos);
     free(mat->dense_idx);
     free(mat->dst);
+    free_hybrid_sp_mat_fglm(mat);
     free(mat);
   }
 }
@@ -252,6 +365,7 @@ static inline param_t *allocate_fglm_param(mp_limb_t prime, long nvars){
   for(long i = 0; i < nvars-1; i++){
     nmod_poly_init(param->coords[i], prime);
   }
+  param->skip = NULL;
   return param;
 }
 
@@ -369,56 +369,61 @@ static inline void solveHankel(nmod_poly_t param,
 /*
  Z1 and Z2 must be arrays of length d + 1
  Mirroring them will give an array of length d + 1
+
+ Z1 and Z2 are only read from data_bms, all other polynomials used as
+ scratch space are taken from tmp (which may be data_bms itself) so that
+ several coordinates can be solved at the same time.
  */
 
-static inline void solve_hankel(fglm_bms_data_t *data_bms, 
+static inline void solve_hankel(fglm_bms_data_t *data_bms,
+                                fglm_bms_data_t *tmp,
                                 szmat_t dimquot,
                                 szmat_t dim,
                                 szmat_t block_size,
                                 CF_t *res,
                                 int ncoord){
-  data_bms->V->length = dim;
+  tmp->V->length = dim;
 
   for(long i = 0; i < dim; i++){
-    data_bms->V->coeffs[i] = res[ncoord-1+i*(block_size)];
+    tmp->V->coeffs[i] = res[ncoord-1+i*(block_size)];
   }
 
   #if DEBUGFGLM > 0
   fprintf(stdout, "\n ncoord = %d\n", ncoord);
   fprintf(stdout, "V = ");
-  nmod_poly_fprint_pretty(stdout, data_bms->V, "x");
+  nmod_poly_fprint_pretty(stdout, tmp->V, "x");
   fprintf(stdout, "\n");
   #endif
 
-  mirror_poly_inplace(data_bms->V);
-  mirror_poly_solve(data_bms->rZ1, data_bms->Z1, dim + 1);
-  mirror_poly_solve(data_bms->rZ2, data_bms->Z2, dim + 1);
+  mirror_poly_inplace(tmp->V);
+  mirror_poly_solve(tmp->rZ1, data_bms->Z1, dim + 1);
+  mirror_poly_solve(tmp->rZ2, data_bms->Z2, dim + 1);
 
-  nmod_poly_mullow(data_bms->A, data_bms->rZ1, data_bms->V, dim); // mod t^dim
-  nmod_poly_mullow(data_bms->B, data_bms->Z2, data_bms->V, dim); // mod t^dim
+  nmod_poly_mullow(tmp->A, tmp->rZ1, tmp->V, dim); // mod t^dim
+  nmod_poly_mullow(tmp->B, data_bms->Z2, tmp->V, dim); // mod t^dim
 
-  mirror_poly_solve(data_bms->rZ1, data_bms->B, dim); 
+  mirror_poly_solve(tmp->rZ1, tmp->B, dim);
 
   for(szmat_t i = 0; i < dim ; i++){
-    data_bms->B->coeffs[i] = data_bms->rZ1->coeffs[i];
+    tmp->B->coeffs[i] = tmp->rZ1->coeffs[i];
   }
-  data_bms->B->length = data_bms->rZ1->length;
-  mirror_poly_solve(data_bms->rZ1, data_bms->A, dim); 
+  tmp->B->length = tmp->rZ1->length;
+  mirror_poly_solve(tmp->rZ1, tmp->A, dim);
   for(szmat_t i = 0; i < dim ; i++){
-    data_bms->A->coeffs[i] = data_bms->rZ1->coeffs[i];
+    tmp->A->coeffs[i] = tmp->rZ1->coeffs[i];
   }
-  data_bms->A->length = data_bms->rZ1->length;
+  tmp->A->length = tmp->rZ1->length;
 
-  nmod_poly_mullow(data_bms->rZ1, data_bms->Z1, data_bms->B, dim);
-  nmod_poly_mullow(data_bms->rZ2, data_bms->rZ2, data_bms->A, dim);
+  nmod_poly_mullow(tmp->rZ1, data_bms->Z1, tmp->B, dim);
+  nmod_poly_mullow(tmp->rZ2, tmp->rZ2, tmp->A, dim);
 
-  nmod_poly_neg(data_bms->rZ2, data_bms->rZ2);
+  nmod_poly_neg(tmp->rZ2, tmp->rZ2);
 
-  nmod_poly_add(data_bms->param, data_bms->rZ1, data_bms->rZ2);
+  nmod_poly_add(tmp->param, tmp->rZ1, tmp->rZ2);
 
   mp_limb_t inv = n_invmod(data_bms->Z1->coeffs[0], (data_bms->Z1->mod).n);
 
-  nmod_poly_scalar_mul_nmod(data_bms->param, data_bms->param, inv);
+  nmod_poly_scalar_mul_nmod(tmp->param, tmp->param, inv);
 
 }
 
@@ -449,6 +454,28 @@ static inline void sparse_mat_fglm_mult_vec(CF_t *res, sp_matfglm_t *mat,
   for(szmat_t i = 0; i < ntriv; i++){
     res[mat->triv_idx[i]] = vec[mat->triv_pos[i]];
   }
+  if(mat->nsp > 0){
+    /* hybrid storage: the dense rows first, then the CSR ones */
+    const szmat_t nhd = nrows - mat->nsp;
+#ifdef HAVE_AVX2
+    _8mul_matrix_vector_product(vres, mat->hd_mat, vec, mat->hd_dst,
+                                ncols, nhd, prime, RED_32, RED_64,
+                                preinv,st);
+#else
+    non_avx_matrix_vector_product(vres, mat->hd_mat, vec,
+                                  ncols, nhd, prime, RED_32, RED_64,st);
+#endif
+    sparse_matrix_vector_product(vres + nhd, mat->sp_start, mat->sp_col,
+                                 mat->sp_val, vec, mat->nsp,
+                                 prime, RED_32, RED_64, st);
+    for(szmat_t i = 0; i < nhd; i++){
+      res[mat->dense_idx[mat->hd_row[i]]] = vres[i];
+    }
+    for(szmat_t i = 0; i < mat->nsp; i++){
+      res[mat->dense_idx[mat->sp_row[i]]] = vres[nhd + i];
+    }
+    return;
+  }
   /* printf("ncols %u\n", ncols); */
 #ifdef HAVE_AVX2
   /* matrix_vector_product(vres, mat->dense_mat, vec, ncols, nrows, prime, RED_32, RED_64); */
@@ -903,6 +930,43 @@ static inline void compute_minpoly(param_t *param,
   /* } */
 
 }
+/*
+  When the eliminating polynomial is known to have degree dimquot (this is
+  what the first prime tells us in the trace based multi-modular
+  computation), the Hankel matrix of the sequence of size dimquot is
+  invertible. Its inverse is needed anyway for the parametrizations, hence
+  the eliminating polynomial x^dimquot + c(x) is obtained by solving
+  H c = -(a_dimquot, ..., a_{2dimquot-1}) instead of running
+  Berlekamp-Massey.
+  This saves the Berlekamp-Massey extended gcd only: inverting H still
+  costs two extended gcds per prime (one for Z1, one on the mirrored
+  sequence for Z2), as H^{-1} depends on the prime and cannot be reused.
+
+  returns 0 when this prime does not behave as the first one.
+ */
+static inline int compute_minpoly_hankel(param_t *param,
+                                         fglm_data_t *data,
+                                         fglm_bms_data_t *data_bms,
+                                         long dimquot,
+                                         long block_size){
+  nmod_berlekamp_massey_add_points(data_bms->BMS, data->pts, 2*dimquot);
+
+  if(invert_hankel_matrix(data_bms, dimquot) == 0){
+    return 0;
+  }
+  solve_hankel(data_bms, data_bms, dimquot, dimquot, block_size,
+               data->res + dimquot * block_size, 1);
+
+  /* compute_coordinate reads the solution H^{-1} V as the reverse of
+     -data_bms->param, the coefficients -H^{-1} V of the eliminating
+     polynomial are hence the reverse of data_bms->param itself */
+  nmod_poly_reverse(param->elim, data_bms->param, dimquot);
+  nmod_poly_set_coeff_ui(param->elim, dimquot, 1);
+  nmod_poly_one(param->denom);
+
+  return nmod_poly_is_squarefree(param->elim);
+}
+
 static void set_param_linear_vars(param_t *param,
                                   long nlins,
                                   uint64_t *linvars,
@@ -999,6 +1063,29 @@ static void set_param_linear_vars(param_t *param,
 #endif
 }
 
+/* computes param->coords[idx] from the column ncoord of the Krylov
+   sequence, tmp is used as scratch space */
+static inline void compute_coordinate(param_t *param,
+                                      fglm_bms_data_t *data_bms,
+                                      fglm_bms_data_t *tmp,
+                                      long dimquot,
+                                      long dim,
+                                      long block_size,
+                                      CF_t *res,
+                                      int ncoord,
+                                      long idx){
+  solve_hankel(data_bms, tmp, dimquot, dim, block_size, res, ncoord);
+
+  nmod_poly_neg(tmp->param, tmp->param);
+  nmod_poly_reverse(param->coords[idx], tmp->param, dim);
+  nmod_poly_rem(param->coords[idx], param->coords[idx], param->elim);
+
+#if DEBUGFGLM > 0
+  nmod_poly_fprint_pretty(stdout, param->coords[idx], "X");
+  fprintf(stdout, "\n");
+#endif
+}
+
 static int compute_parametrizations(param_t *param,
                                     fglm_data_t *data,
                                     fglm_bms_data_t *data_bms,
@@ -1008,12 +1095,14 @@ static int compute_parametrizations(param_t *param,
                                     long nlins,
                                     uint64_t *linvars,
                                     uint32_t *lineqs,
-                                    long nvars){
+                                    long nvars,
+                                    const int nthrds,
+                                    const int inverted){
 
   nmod_poly_one(param->denom);
 
   int b = 1;
-  if(nlins != nvars){
+  if(nlins != nvars && !inverted){
     b = invert_hankel_matrix(data_bms, dim);
 #if DEBUGFGLM > 0
     fprintf(stdout, "Z1 = "); nmod_poly_fprint_pretty(stdout, data_bms->Z1, "x");fprintf(stdout, "\n");
@@ -1024,22 +1113,31 @@ static int compute_parametrizations(param_t *param,
   if(b){
 
     long dec = 0;
+    long nsolve = 0;
+    /* ncoord[nc] is the column of data->res used for the coordinate
+       nvars-2-nc, or 0 when this coordinate is a linear form or is
+       skipped */
+    int *ncoord = calloc(nvars, sizeof(int));
+
+    /* coordinates given by linear forms are computed from the other
+       ones, hence nothing is skipped if one of them is needed */
+    const int *skip = param->skip;
+    for(long i = 0; i < nvars - 1 && skip != NULL; i++){
+      if(linvars[i] != 0 && skip[i] == 0){
+        skip = NULL;
+      }
+    }
 
     for(long nc = 0; nc < nvars - 1 ; nc++){
 
       if(linvars[nvars - 2- nc] == 0){
-        solve_hankel(data_bms, dimquot, dim, block_size, data->res,
-                     nc + 2 - dec);
-
-        nmod_poly_neg(data_bms->param, data_bms->param);
-        nmod_poly_reverse(param->coords[nvars-2-nc], data_bms->param, dim);
-        nmod_poly_rem(param->coords[nvars-2-nc], param->coords[nvars-2-nc],
-                      param->elim);
-
-#if DEBUGFGLM > 0
-        nmod_poly_fprint_pretty(stdout, param->coords[nvars-2-nc], "X");
-        fprintf(stdout, "\n");
-#endif
+        if(skip != NULL && skip[nvars - 2 - nc]){
+          nmod_poly_zero(param->coords[nvars - 2 - nc]);
+        }
+        else{
+          ncoord[nc] = nc + 2 - dec;
+          nsolve++;
+        }
       }
       else{
 
@@ -1057,6 +1155,41 @@ static int compute_parametrizations(param_t *param,
       }
     }
 
+#ifdef _OPENMP
+    /* when called from a loop over primes which is already parallel,
+       we stay sequential */
+    if(nthrds > 1 && nsolve > 1 && !omp_in_parallel()){
+      const int nth = MIN(nthrds, nsolve);
+      fglm_bms_data_t **tmp = malloc(nth * sizeof(fglm_bms_data_t *));
+      for(int i = 0; i < nth; i++){
+        tmp[i] = allocate_fglm_bms_data(dim, (data_bms->Z1->mod).n);
+      }
+#pragma omp parallel for num_threads(nth) schedule(dynamic)
+      for(long nc = 0; nc < nvars - 1 ; nc++){
+        if(ncoord[nc] != 0){
+          compute_coordinate(param, data_bms, tmp[omp_get_thread_num()],
+                             dimquot, dim, block_size, data->res,
+                             ncoord[nc], nvars - 2 - nc);
+        }
+      }
+      for(int i = 0; i < nth; i++){
+        free_fglm_bms_data(tmp[i]);
+      }
+      free(tmp);
+    }
+    else
+#endif
+    {
+      for(long nc = 0; nc < nvars - 1 ; nc++){
+        if(ncoord[nc] != 0){
+          compute_coordinate(param, data_bms, data_bms,
+                             dimquot, dim, block_size, data->res,
+                             ncoord[nc], nvars - 2 - nc);
+        }
+      }
+    }
+    free(ncoord);
+
     set_param_linear_vars(param, nlins, linvars, lineqs, nvars);
 
 #if DEBUGFGLM > 0
@@ -1428,6 +1561,7 @@ static inline long initialize_fglm_data(sp_matfglm_t *matrix,
     if(matrix->dense_mat[i]==0)
       nb++;
   }
+  build_hybrid_sp_mat_fglm(matrix);
   srand(time(NULL));
   for(szmat_t i = 0; i < matrix->ncols; i++){
     data->vecinit[i] = (CF_t)rand() % prime;
@@ -1562,7 +1696,7 @@ param_t *nmod_fglm_compute(sp_matfglm_t *matrix, const mod_t prime, const long n
     if(compute_parametrizations(param, data, data_bms,
                                 dim, dimquot, block_size,
                                 nlins, linvars, lineqs,
-                                nvars) == 0){
+                                nvars, st->nthrds, 0) == 0){
 
       fprintf(stderr, "Matrix is not invertible (there should be a bug)\n");
       free_fglm_bms_data(data_bms);
@@ -1703,7 +1837,7 @@ param_t *nmod_fglm_compute_trace_data(sp_matfglm_t *matrix, mod_t prime,
     if(compute_parametrizations(param, *bdata, *bdata_bms,
 				dim, dimquot, block_size,
 				nlins, linvars, lineqs,
-				nvars) == 0){
+				nvars, st->nthrds, 0) == 0){
 
       fprintf(stderr, "Matrix is not invertible (there should be a bug)\n");
       return NULL;
@@ -1842,6 +1976,30 @@ int nmod_fglm_compute_apply_trace_data(sp_matfglm_t *matrix,
 
   fglm_bms_data_set_prime(data_bms, prime);
 
+  if(deg_init == dimquot && nlins != nvars && dimquot > 1){
+    /* shape position case, as for the first prime */
+    if(compute_minpoly_hankel(param, data_fglm, data_bms,
+                              dimquot, block_size) == 0){
+      fprintf(stderr, "Warning: Degree of elim poly is not %ld\n", deg_init);
+      return 1;
+    }
+    if(info_level > 1){
+      fprintf(stderr, "Eliminating polynomial obtained from the Hankel matrix\n");
+    }
+    if(info_level){
+      fprintf(stderr, "Time spent to compute eliminating polynomial (elapsed): %.2f sec\n",
+              realtime()-st_fglm);
+    }
+    if(compute_parametrizations(param, data_fglm, data_bms,
+                                dimquot, dimquot, block_size,
+                                nlins, linvars, lineqs,
+                                nvars, st->nthrds, 1) == 0){
+      fprintf(stderr, "Warning: Matrix is not invertible for this prime\n");
+      return 1;
+    }
+    return 0;
+  }
+
   long dim = 0;
   compute_minpoly(param, data_fglm, data_bms, dimquot, linvars, lineqs, nvars, &dim,
                   info_level);
@@ -1860,7 +2018,7 @@ int nmod_fglm_compute_apply_trace_data(sp_matfglm_t *matrix,
     if(compute_parametrizations(param, data_fglm, data_bms,
 				dim, dimquot, block_size,
 				nlins, linvars, lineqs,
-				nvars) == 0){
+				nvars, st->nthrds, 0) == 0){
 
       fprintf(stderr, "Matrix is not invertible (there should be a bug)\n");
       exit(1);
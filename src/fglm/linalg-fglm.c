@@ -778,3 +778,62 @@ static inline void _8mul_matrix_vector_product(uint32_t* vec_res,
     }
 }
 #endif
+
+/**
+Matrix vector product for rows stored in CSR format.
+Row j has its non zero entries vals[start[j] .. start[j+1]-1] at the
+columns cols[start[j] .. start[j+1]-1]. With AVX2, the entries of vec are
+gathered eight by eight and accumulated as in _8mul_matrix_vector_product.
+**/
+
+static inline void sparse_matrix_vector_product(uint32_t* vec_res,
+                                                const uint64_t *start,
+                                                const uint32_t *cols,
+                                                const uint32_t *vals,
+                                                const uint32_t *vec,
+                                                const uint32_t nrows,
+                                                const uint32_t PRIME,
+                                                const uint32_t RED_32,
+                                                const uint32_t RED_64,
+                                                md_t *st){
+  const uint64_t modsquare = (uint64_t)PRIME*PRIME;
+
+#pragma omp parallel for num_threads (st->nthrds) schedule(dynamic, 64)
+  for(uint32_t j = 0; j < nrows; ++j){
+    uint64_t k = start[j];
+    const uint64_t end = start[j+1];
+    uint64_t acc64 = 0;
+#ifdef HAVE_AVX2
+    if(end - k >= 8){
+      __m256i mask = AVX2SET1_64(MONE32);
+      __m256i acc_low = AVX2SETZERO();
+      __m256i acc_high = AVX2SETZERO();
+      __m256i vec8, mat8, idx8, prod1, prod2, res1;
+      uint64_t acc4x64[8];
+
+      for(; k + 8 <= end; k += 8){
+        idx8 = AVX2LOADU(cols + k);
+        mat8 = AVX2LOADU(vals + k);
+        vec8 = _mm256_i32gather_epi32((const int *)vec, idx8, 4);
+        prod1 = AVX2MUL(mat8, vec8);
+        prod2 = AVX2MUL(AVX2SRLI_64(mat8,32), AVX2SRLI_64(vec8,32));
+        res1 = prod1 + prod2;
+        acc_low = AVX2ADD_64(acc_low, AVX2AND_(res1, mask));
+        acc_high = AVX2ADD_64(acc_high, AVX2SRLI_64(res1, 32));
+      }
+      AVX2STOREU(acc4x64, acc_low);
+      AVX2STOREU(acc4x64+4, acc_high);
+      for(int i = 0; i < 4; ++i){
+        acc4x64[i] += ((acc4x64[i+4]>>32)*RED_64)%PRIME;
+        acc4x64[i] += ((acc4x64[i+4]&((uint64_t)0xFFFFFFFF))*RED_32)%PRIME;
+        acc64 += acc4x64[i]%PRIME;
+      }
+    }
+#endif
+    for(; k < end; ++k){
+      acc64 += (uint64_t)vals[k] * vec[cols[k]];
+      acc64 -= modsquare & -(uint64_t)(acc64 >= modsquare);
+    }
+    vec_res[j] = acc64 % PRIME;
+  }
+}
@@ -60,17 +60,17 @@ static inline void duplicate_tracer(
                 btrace[i]->td[l].tld = btrace[0]->td[l].tld;
                 btrace[i]->td[l].nlm = btrace[0]->td[l].nlm;
 
-                btrace[i]->td[l].rri = calloc(btrace[0]->td[l].rld,
-                        sizeof(len_t));
-                for(len_t k = 0; k < (btrace[0]->td[l].rld ); ++k){
-                    btrace[i]->td[l].rri[k] = btrace[0]->td[l].rri[k] ;
-                }
+                btrace[i]->td[l].rrl = btrace[0]->td[l].rrl;
+                btrace[i]->td[l].trl = btrace[0]->td[l].trl;
+                btrace[i]->td[l].rbl = btrace[0]->td[l].rbl;
 
-                btrace[i]->td[l].tri = calloc(btrace[0]->td[l].tld,
-                        sizeof(len_t));
-                for(len_t k = 0; k < (btrace[0]->td[l].tld); ++k){
-                    btrace[i]->td[l].tri[k] = btrace[0]->td[l].tri[k] ;
-                }
+                btrace[i]->td[l].rri = malloc(btrace[0]->td[l].rrl + 1);
+                memcpy(btrace[i]->td[l].rri, btrace[0]->td[l].rri,
+                        btrace[0]->td[l].rrl);
+
+                btrace[i]->td[l].tri = malloc(btrace[0]->td[l].trl + 1);
+                memcpy(btrace[i]->td[l].tri, btrace[0]->td[l].tri,
+                        btrace[0]->td[l].trl);
 
                 btrace[i]->td[l].nlms = calloc(btrace[0]->td[l].nlm,
                         sizeof(len_t));
@@ -78,21 +78,9 @@ static inline void duplicate_tracer(
                     btrace[i]->td[l].nlms[k] = btrace[0]->td[l].nlms[k];
                 }
 
-                btrace[i]->td[l].rba = (rba_t **)malloc((unsigned long)btrace[0]->td[l].tld * sizeof(rba_t *));
-
-                const len_t nrr   = btrace[0]->td[l].rld;
-
-                const unsigned long nlrba = nrr / 2 / 32 + (((nrr / 2) % 32) != 0);
-
-                for(len_t j = 0; j < (btrace[0]->td[l].tld / 2); ++j) {
-                    btrace[i]->td[l].rba[j]  = calloc(nlrba, sizeof(rba_t));
-                }
-
-                for (len_t j = 0; j < (btrace[0]->td[l].tld / 2); ++j) {
-                    for(len_t k = 0; k < nlrba; k++){
-                        btrace[i]->td[l].rba[j][k]  = btrace[0]->td[l].rba[j][k];
-                    }
-                }
+                btrace[i]->td[l].rba = malloc(btrace[0]->td[l].rbl + 1);
+                memcpy(btrace[i]->td[l].rba, btrace[0]->td[l].rba,
+                        btrace[0]->td[l].rbl);
 
             }
         }
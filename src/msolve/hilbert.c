@@ -82,6 +82,130 @@ static inline int has_dimension_zero(const long length, const int nv,
   return 0;
 }
 
+/*
+  Hash index on an array of exponent vectors (e.g. the monomial basis of
+  the quotient ring or the leading monomials of a Groebner basis) to
+  replace linear scans such as member_xxn or is_divisible_lexp.
+  The exponents are not copied, exp must outlive the index.
+ */
+typedef struct{
+  int32_t *exp;
+  long nv;
+  long len; //nbre d'exposants indexes
+  uint64_t mask; //taille de la table - 1 (puissance de 2)
+  int64_t *tab; //-1 si vide, sinon position dans exp
+} exp_idx_t;
+
+/* hashes exp * x_n^inc */
+static inline uint64_t hash_exp_idx(const int32_t *exp, const long nv,
+                                    const int32_t inc){
+  uint64_t h = 0;
+  for(long k = 0; k < nv - 1; k++){
+    h = (h ^ (uint32_t)exp[k]) * 0x9E3779B97F4A7C15ULL;
+  }
+  h = (h ^ (uint32_t)(exp[nv-1] + inc)) * 0x9E3779B97F4A7C15ULL;
+  return h ^ (h >> 29);
+}
+
+static inline void insert_exp_idx(exp_idx_t *idx, const long pos){
+  if(2 * (uint64_t)(idx->len + 1) > idx->mask + 1){
+    const uint64_t size = 2 * (idx->mask + 1);
+    free(idx->tab);
+    idx->tab = malloc(size * sizeof(int64_t));
+    idx->mask = size - 1;
+    for(uint64_t i = 0; i < size; i++){
+      idx->tab[i] = -1;
+    }
+    const long len = idx->len;
+    idx->len = 0;
+    for(long i = 0; i < len; i++){
+      insert_exp_idx(idx, i);
+    }
+  }
+  uint64_t h = hash_exp_idx(idx->exp + pos * idx->nv, idx->nv, 0) & idx->mask;
+  while(idx->tab[h] != -1){
+    h = (h + 1) & idx->mask;
+  }
+  idx->tab[h] = pos;
+  idx->len++;
+}
+
+/* indexes the len first exponents of exp, the ones which are added later
+   on must be inserted in increasing order with insert_exp_idx (after
+   updating idx->exp if exp is reallocated) */
+static inline exp_idx_t *init_exp_idx(int32_t *exp, const long len,
+                                      const long nv){
+  exp_idx_t *idx = malloc(sizeof(exp_idx_t));
+  uint64_t size = 16;
+  while(size < 2 * (uint64_t)len){
+    size <<= 1;
+  }
+  idx->exp = exp;
+  idx->nv = nv;
+  idx->len = 0;
+  idx->mask = size - 1;
+  idx->tab = malloc(size * sizeof(int64_t));
+  for(uint64_t i = 0; i < size; i++){
+    idx->tab[i] = -1;
+  }
+  for(long i = 0; i < len; i++){
+    insert_exp_idx(idx, i);
+  }
+  return idx;
+}
+
+static inline void free_exp_idx(exp_idx_t *idx){
+  if(idx != NULL){
+    free(idx->tab);
+    free(idx);
+  }
+}
+
+/* returns the position of exp * x_n^inc in the index, -1 if not found */
+static inline long find_exp_idx(const exp_idx_t *idx, const int32_t *exp,
+                                const int32_t inc){
+  const long nv = idx->nv;
+  uint64_t h = hash_exp_idx(exp, nv, inc) & idx->mask;
+  while(idx->tab[h] != -1){
+    const int32_t *e = idx->exp + idx->tab[h] * nv;
+    long k = 0;
+    while(k < nv - 1 && e[k] == exp[k]){
+      k++;
+    }
+    if(k == nv - 1 && e[k] == exp[k] + inc){
+      return idx->tab[h];
+    }
+    h = (h + 1) & idx->mask;
+  }
+  return -1;
+}
+
+/*
+  u is a monomial of degree d + 1 and bidx indexes all monomials of degree
+  d of the staircase. Then u lies in the staircase iff u is not a leading
+  monomial and all u / x_j lie in the staircase. This replaces the
+  divisibility test of u by all leading monomials with nvars + 1 lookups.
+  u is modified during the call but restored on return.
+ */
+static inline int is_in_staircase_idx(int32_t *u, const long nvars,
+                                      const exp_idx_t *bidx,
+                                      const exp_idx_t *lmidx){
+  if(find_exp_idx(lmidx, u, 0) >= 0){
+    return 0;
+  }
+  for(long j = 0; j < nvars; j++){
+    if(u[j] > 0){
+      u[j]--;
+      const long pos = find_exp_idx(bidx, u, 0);
+      u[j]++;
+      if(pos < 0){
+        return 0;
+      }
+    }
+  }
+  return 1;
+}
+
 static inline int is_divisible_exp(long nvars, int32_t *exp1, int32_t *exp2){
   for(long i = 0; i < nvars; i++){
     if(exp2[i]>exp1[i]){
@@ -147,7 +271,9 @@ static inline int32_t sum(int32_t *ind, int32_t length){
 static inline int32_t generate_new_elts_basis(int32_t nvars, int32_t *ind,
                                               long len1, long len_lm,
                                               int32_t *basis1, int32_t *new_basis,
-                                              int32_t *bexp_lm){
+                                              int32_t *bexp_lm,
+                                              const exp_idx_t *bidx,
+                                              const exp_idx_t *lmidx){
   long c = 0;
   for(int32_t n = nvars-1; n >= 0; n--){
     for(int32_t i = ind[nvars-1-n]; i < len1; i++){
@@ -155,7 +281,7 @@ static inline int32_t generate_new_elts_basis(int32_t nvars, int32_t *ind,
         new_basis[c*nvars+k] = basis1[i*nvars+k];
       }
       new_basis[c*nvars+n]++;
-      if(!is_divisible_lexp(nvars, len_lm, (new_basis+c*nvars), bexp_lm)){
+      if(is_in_staircase_idx(new_basis+c*nvars, nvars, bidx, lmidx)){
         c++;
       }
     }
@@ -205,6 +331,8 @@ static inline int32_t *monomial_basis(long length, long nvars,
     (*dquot)++;
   }
   int32_t *ind = calloc(nvars, sizeof(int32_t));
+  exp_idx_t *bidx = init_exp_idx(basis, *dquot, nvars);
+  exp_idx_t *lmidx = init_exp_idx(bexp_lm, length, nvars);
 
 #ifdef DEBUGHILBERT
   fprintf(stderr, "new = %ld \n", sum(ind, nvars) + nvars);
@@ -212,7 +340,8 @@ static inline int32_t *monomial_basis(long length, long nvars,
 
   int32_t *new_basis = malloc(sizeof(int32_t) * nvars * (sum(ind, nvars) + nvars));
   int32_t new_length = generate_new_elts_basis(nvars, ind, (*dquot), length,
-                                            basis, new_basis, bexp_lm);
+                                            basis, new_basis, bexp_lm,
+                                            bidx, lmidx);
 #ifdef DEBUGHILBERT
   //  display_monomials_from_array(stderr, new_length, new_basis, gens);
   fprintf(stderr, "%ld new elements.\n", new_length);
@@ -231,6 +360,10 @@ static inline int32_t *monomial_basis(long length, long nvars,
         (basis)[((*dquot) + i)*nvars+k] = (new_basis)[i*nvars+k];
       }
     }
+    bidx->exp = basis;
+    for(long i = 0; i < new_length; i++){
+      insert_exp_idx(bidx, (*dquot) + i);
+    }
 
     update_indices(ind, basis, *dquot, new_length, nvars);
     (*dquot) += new_length;
@@ -250,7 +383,8 @@ static inline int32_t *monomial_basis(long length, long nvars,
     }
     new_basis=new_basis2;
     new_length = generate_new_elts_basis(nvars, ind, (*dquot), length,
-                                         basis, new_basis, bexp_lm);
+                                         basis, new_basis, bexp_lm,
+                                         bidx, lmidx);
 #ifdef DEBUGHILBERT
     fprintf(stderr, "%ld new elements.\n", new_length);
 #endif
@@ -258,6 +392,8 @@ static inline int32_t *monomial_basis(long length, long nvars,
 
   free(new_basis);
   free(ind);
+  free_exp_idx(bidx);
+  free_exp_idx(lmidx);
   return basis;
 }
 
@@ -283,6 +419,8 @@ static inline int32_t *monomial_basis_colon(long length, long nvars,
     (*dquot)++;
   }
   int32_t *ind = calloc(nvars, sizeof(int32_t));
+  exp_idx_t *bidx = init_exp_idx(basis, *dquot, nvars);
+  exp_idx_t *lmidx = init_exp_idx(bexp_lm, length, nvars);
 
 #ifdef DEBUGHILBERT
   fprintf(stderr, "new = %ld \n", sum(ind, nvars) + nvars);
@@ -291,7 +429,8 @@ static inline int32_t *monomial_basis_colon(long length, long nvars,
 
   int32_t *new_basis = malloc(sizeof(int32_t) * nvars * (sum(ind, nvars) + nvars)); 
   long new_length = generate_new_elts_basis(nvars, ind, (*dquot), length,
-                                            basis, new_basis, bexp_lm);
+                                            basis, new_basis, bexp_lm,
+                                            bidx, lmidx);
 #ifdef DEBUGHILBERT
   display_monomials_from_array(stderr, new_length, new_basis, gens);
   fprintf(stderr, "%ld new elements.\n", new_length);
@@ -310,6 +449,10 @@ static inline int32_t *monomial_basis_colon(long length, long nvars,
         (basis)[((*dquot) + i)*nvars+k] = (new_basis)[i*nvars+k];
       }
     }
+    bidx->exp = basis;
+    for(long i = 0; i < new_length; i++){
+      insert_exp_idx(bidx, (*dquot) + i);
+    }
 
     update_indices(ind, basis, *dquot, new_length, nvars);
     (*dquot) += new_length;
@@ -329,7 +472,8 @@ static inline int32_t *monomial_basis_colon(long length, long nvars,
     }
     new_basis=new_basis2;
     new_length = generate_new_elts_basis(nvars, ind, (*dquot), length,
-                                         basis, new_basis, bexp_lm);
+                                         basis, new_basis, bexp_lm,
+                                         bidx, lmidx);
 #ifdef DEBUGHILBERT
     fprintf(stderr, "%ld new elements.\n", new_length);
 #endif
@@ -338,6 +482,8 @@ static inline int32_t *monomial_basis_colon(long length, long nvars,
 
   free(new_basis);
   free(ind);
+  free_exp_idx(bidx);
+  free_exp_idx(lmidx);
   return basis;
 }
 
@@ -362,6 +508,8 @@ static inline int32_t *monomial_basis_colon_no_zero(long length, long nvars,
     (*dquot)++;
   }
   int32_t *ind = calloc(nvars, sizeof(int32_t));
+  exp_idx_t *bidx = init_exp_idx(basis, *dquot, nvars);
+  exp_idx_t *lmidx = init_exp_idx(bexp_lm, length, nvars);
 
 #ifdef DEBUGHILBERT
   fprintf(stderr, "new = %ld \n", sum(ind, nvars) + nvars);
@@ -369,7 +517,8 @@ static inline int32_t *monomial_basis_colon_no_zero(long length, long nvars,
 
   int32_t *new_basis = malloc(sizeof(int32_t) * nvars * (sum(ind, nvars) + nvars)); 
   long new_length = generate_new_elts_basis(nvars, ind, (*dquot), length,
-                                            basis, new_basis, bexp_lm);
+                                            basis, new_basis, bexp_lm,
+                                            bidx, lmidx);
 #ifdef DEBUGHILBERT
   display_monomials_from_array(stderr, new_length, new_basis, gens);
   fprintf(stderr, "%ld new elements.\n", new_length);
@@ -388,6 +537,10 @@ static inline int32_t *monomial_basis_colon_no_zero(long length, long nvars,
         (basis)[((*dquot) + i)*nvars+k] = (new_basis)[i*nvars+k];
       }
     }
+    bidx->exp = basis;
+    for(long i = 0; i < new_length; i++){
+      insert_exp_idx(bidx, (*dquot) + i);
+    }
 
     update_indices(ind, basis, *dquot, new_length, nvars);
     (*dquot) += new_length;
@@ -407,7 +560,8 @@ static inline int32_t *monomial_basis_colon_no_zero(long length, long nvars,
     }
     new_basis=new_basis2;
     new_length = generate_new_elts_basis(nvars, ind, (*dquot), length,
-                                         basis, new_basis, bexp_lm);
+                                         basis, new_basis, bexp_lm,
+                                         bidx, lmidx);
 #ifdef DEBUGHILBERT
     fprintf(stderr, "%ld new elements.\n", new_length);
 #endif
@@ -415,6 +569,8 @@ static inline int32_t *monomial_basis_colon_no_zero(long length, long nvars,
   }
   free(new_basis);
   free(ind);
+  free_exp_idx(bidx);
+  free_exp_idx(lmidx);
 
   /* cleanup by removing monomials that will be sent to 0 after
      iterative multiplication by xn */
@@ -1203,6 +1359,8 @@ static inline int32_t *monomial_basis_enlarged(long length, long nvars,
     (*dquot)++;
   }
   int32_t *ind = calloc(nvars, sizeof(int32_t));
+  exp_idx_t *bidx = init_exp_idx(basis, *dquot, nvars);
+  exp_idx_t *lmidx = init_exp_idx(bexp_lm, length, nvars);
 
 #ifdef DEBUGHILBERT
   fprintf(stderr, "new = %ld \n", sum(ind, nvars) + nvars);
@@ -1210,7 +1368,8 @@ static inline int32_t *monomial_basis_enlarged(long length, long nvars,
 
   int32_t *new_basis = malloc(sizeof(int32_t) * (nvars) * (sum(ind, nvars) + nvars));
   int32_t new_length = generate_new_elts_basis(nvars, ind, (*dquot), length,
-                                               basis, new_basis, bexp_lm);
+                                               basis, new_basis, bexp_lm,
+                                               bidx, lmidx);
   deg++;
 #ifdef DEBUGHILBERT
   //  display_monomials_from_array(stderr, new_length, new_basis, gens);
@@ -1231,6 +1390,10 @@ static inline int32_t *monomial_basis_enlarged(long length, long nvars,
         (basis)[((*dquot) + i)*(nvars)+k] = (new_basis)[i*(nvars)+k];
       }
     }
+    bidx->exp = basis;
+    for(long i = 0; i < new_length; i++){
+      insert_exp_idx(bidx, (*dquot) + i);
+    }
 
     update_indices(ind, basis, *dquot, new_length, nvars);
     (*dquot) += new_length;
@@ -1250,7 +1413,8 @@ static inline int32_t *monomial_basis_enlarged(long length, long nvars,
     }
     new_basis=new_basis2;
     new_length = generate_new_elts_basis(nvars, ind, (*dquot), length,
-                                         basis, new_basis, bexp_lm);
+                                         basis, new_basis, bexp_lm,
+                                         bidx, lmidx);
     deg++;
 #ifdef DEBUGHILBERT
     fprintf(stderr, "%ld new elements.\n", new_length);
@@ -1259,6 +1423,8 @@ static inline int32_t *monomial_basis_enlarged(long length, long nvars,
 
   free(new_basis);
   free(ind);
+  free_exp_idx(bidx);
+  free_exp_idx(lmidx);
   return basis;
 }
 
@@ -1539,10 +1705,10 @@ build_matrixn_colon(int32_t *lmb, long dquot, int32_t bld,
      multiplication by xn and land on zero */
   long *zeronf= calloc (dquot, sizeof(long));
   long count_zero = 0;
+  exp_idx_t *lidx = init_exp_idx(lmb, dquot, nv);
   for (long i = 0; i < dquot; i++) {
-        long pos = -1;
 	int32_t *exp = lmb + (i * nv);
-	if(member_xxn(exp, lmb + (i * nv), dquot - i, &pos, nv)){
+	if(find_exp_idx(lidx, exp, 1) > i){
 #if DEBUGBUILDMATRIX>0
 	  display_monomial_full(stderr, nv, NULL, 0, exp);
 	  fprintf(stderr, " => remains in monomial basis\n");
@@ -1583,6 +1749,7 @@ build_matrixn_colon(int32_t *lmb, long dquot, int32_t bld,
 	  }
 	}
   }
+  free_exp_idx(lidx);
   
   printf ("Number of extra normal forms for the matrix to compute: %ld\n",count_not_lm);
   printf ("Number of extra normal forms for the vectors to compute: %d\n",2*nv-2);
@@ -1991,10 +2158,10 @@ build_matrixn_colon_no_zero(int32_t *lmb, long dquot, int32_t bld,
      multiplication by xn and land on zero */
   /* long *zeronf= calloc (dquot, sizeof(long)); */
   /* long count_zero = 0; */
+  exp_idx_t *lidx = init_exp_idx(lmb, dquot, nv);
   for (long i = 0; i < dquot; i++) {
-        long pos = -1;
 	int32_t *exp = lmb + (i * nv);
-	if(member_xxn(exp, lmb + (i * nv), dquot - i, &pos, nv)){
+	if(find_exp_idx(lidx, exp, 1) > i){
 #if DEBUGBUILDMATRIX > 0
 	  display_monomial_full(stderr, nv, NULL, 0, exp);
 	  fprintf(stderr, " => remains in monomial basis\n");
@@ -2034,6 +2201,7 @@ build_matrixn_colon_no_zero(int32_t *lmb, long dquot, int32_t bld,
 	  }
 	}
   }
+  free_exp_idx(lidx);
   
   printf ("Number of extra normal forms for the matrix to compute: %ld\n",count_not_lm);
   printf ("Number of extra normal forms for the vectors to compute: %d\n",2*nv-2);
@@ -2530,11 +2698,111 @@ static inline sp_matfglm_t * build_matrixn_trace(int32_t **bdiv_xn,
    bexp_lm is the leading monomials of gb ; there are bld[0] of them.
 
  **/
+/*
+  Fills triv_idx, triv_pos, dense_idx, dense_mat and dst for the matrix of
+  the multiplication by x_n. Membership of x_n * m in the staircase is
+  decided through a hash index on lmb, then the rows of dense_mat, which
+  are independent, are filled in parallel.
+
+  Returns -1 on success. Otherwise, the staircase is not generic and the
+  index in lmb of the monomial m such that x_n * m gets outside of the
+  staircase is returned.
+ */
+/* copies the coefficients of the polynomials div_xn[0], ..., div_xn[l_dens-1]
+   of bs into the rows of dense_mat, the index structure of matrix is
+   expected to be set already, see fill_matrixn_from_bs */
+static inline void fill_matrixn_coefficients_from_bs(sp_matfglm_t *matrix,
+                                                     int32_t *div_xn,
+                                                     int32_t *len_gb_xn,
+                                                     int32_t *start_cf_gb_xn,
+                                                     const long l_dens,
+                                                     int32_t *lmb,
+                                                     bs_t *bs,
+                                                     ht_t *ht,
+                                                     const int nv,
+                                                     const long fc,
+                                                     const int nthrds){
+  /* row r of dense_mat comes from the polynomial div_xn[r] of the basis */
+  const long ncols = matrix->ncols;
+#pragma omp parallel for num_threads(nthrds) \
+  if(nthrds > 1 && !omp_in_parallel()) schedule(dynamic)
+  for(long r = 0; r < matrix->nrows; r++){
+    if(r < l_dens){
+      copy_poly_in_matrix_from_bs(matrix, r, bs, ht,
+                                  div_xn[r], len_gb_xn[r],
+                                  start_cf_gb_xn[r], len_gb_xn[r], lmb,
+                                  nv, fc);
+    }
+    matrix->dst[r] = 0;
+    for(long j = ncols - 1; j >= 0; j--){
+      if(matrix->dense_mat[r*ncols + j] == 0){
+        matrix->dst[r]++;
+      }
+      else{
+        break;
+      }
+    }
+  }
+}
+
+static inline long fill_matrixn_from_bs(sp_matfglm_t *matrix,
+                                        int32_t *div_xn,
+                                        int32_t *len_gb_xn,
+                                        int32_t *start_cf_gb_xn,
+                                        const long len_xn,
+                                        int32_t *lmb, const long dquot,
+                                        bs_t *bs,
+                                        ht_t *ht,
+                                        int32_t *bexp_lm,
+                                        const int nv,
+                                        const long fc,
+                                        const int nthrds){
+  exp_idx_t *lmb_idx = init_exp_idx(lmb, dquot, nv);
+
+  long l_triv = 0;
+  long l_dens = 0;
+  for(long i = 0; i < dquot; i++){
+    int32_t *exp = lmb + (i * nv);
+#if DEBUGBUILDMATRIX > 0
+    display_monomial_full(stderr, nv, NULL, 0, exp);
+#endif
+    long pos = find_exp_idx(lmb_idx, exp, 1);
+    if(pos >= 0){
+#if DEBUGBUILDMATRIX > 0
+      fprintf(stderr, " => remains in monomial basis\n");
+#endif
+      matrix->triv_idx[l_triv] = i;
+      matrix->triv_pos[l_triv] = pos;
+      l_triv++;
+    }
+    else{
+#if DEBUGBUILDMATRIX > 0
+      fprintf(stderr, " => does NOT remain in monomial basis\n");
+#endif
+      if(l_dens < len_xn &&
+         is_equal_exponent_xxn(exp, bexp_lm+(div_xn[l_dens])*nv, nv)){
+        matrix->dense_idx[l_dens] = i;
+        l_dens++;
+      }
+      else{
+        free_exp_idx(lmb_idx);
+        return i;
+      }
+    }
+  }
+  free_exp_idx(lmb_idx);
+
+  fill_matrixn_coefficients_from_bs(matrix, div_xn, len_gb_xn, start_cf_gb_xn,
+                                    l_dens, lmb, bs, ht, nv, fc, nthrds);
+  return -1;
+}
+
 static inline sp_matfglm_t * build_matrixn_from_bs(int32_t *lmb, long dquot,
                                                    bs_t *bs,
                                                    ht_t *ht,
                                                    int32_t *bexp_lm,
-                                                   const int nv, const long fc){
+                                                   const int nv, const long fc,
+                                                   const int nthrds){
 
 
   int32_t *div_xn = calloc(bs->lml, sizeof(int32_t));
@@ -2627,85 +2895,25 @@ static inline sp_matfglm_t * build_matrixn_from_bs(int32_t *lmb, long dquot,
     }
   }
 
-  long l_triv = 0;
-  long l_dens = 0;
-  long nrows = 0;
-  long count = 0;
-  for(long i = 0; i < dquot; i++){
-
-    long pos = -1;
-    int32_t *exp = lmb + (i * nv);
-#if DEBUGBUILDMATRIX > 0
-    display_monomial_full(stderr, nv, NULL, 0, exp);
-    //    fprintf(stderr, "\n");
-#endif
-    if(member_xxn(exp, lmb + (i * nv), dquot - i, &pos, nv)){
-#if DEBUGBUILDMATRIX > 0
-      fprintf(stderr, " => remains in monomial basis\n");
-#endif
-
-      matrix->triv_idx[l_triv] = i;
-      matrix->triv_pos[l_triv] = pos + i;
-
-      l_triv++;
-    }
-    else{
-
-#if DEBUGBUILDMATRIX > 0
-      fprintf(stderr, " => does NOT remain in monomial basis\n");
-#endif
-      matrix->dense_idx[l_dens] = i;
-      l_dens++;
-      if(is_equal_exponent_xxn(exp, bexp_lm+(div_xn[count])*nv, nv)){
-        copy_poly_in_matrix_from_bs(matrix, nrows, bs, ht, //bcf, bexp, blen,
-                                    div_xn[count], len_gb_xn[count],
-                                    start_cf_gb_xn[count], len_gb_xn[count], lmb,
-                                    nv, fc);
-        nrows++;
-        count++;
-        if(len_xn < count && i < dquot){
-          fprintf(stderr, "One should not arrive here (build_matrix with trace)\n");
-          free(matrix->dense_mat);
-          free(matrix->dense_idx);
-          free(matrix->triv_idx);
-          free(matrix->triv_pos);
-          free(matrix);
-
-          free(len_gb_xn);
-          free(start_cf_gb_xn);
-          free(div_xn);
-          return NULL;
-        }
-      }
-      else{
-        fprintf(stderr, "Staircase is not generic\n");
-        fprintf(stderr, "Multiplication by ");
-        display_monomial_full(stderr, nv, NULL, 0, exp);
-        fprintf(stderr, " gets outside the staircase\n");
-        free(matrix->dense_mat);
-        free(matrix->dense_idx);
-        free(matrix->triv_idx);
-        free(matrix->triv_pos);
-        free(matrix->dst);
-        free(matrix);
-
-        free(len_gb_xn);
-        free(start_cf_gb_xn);
-        free(div_xn);
-        return NULL;
-      }
-    }
-  }
-
-  for(long i = 0; i < matrix->nrows; i++){
-    for(long j = matrix->ncols - 1; j >= 0; j--){
-      if(matrix->dense_mat[i*matrix->ncols + j] == 0){
-        matrix->dst[i]++;
-      }
-      else{
-        break;
-      }
-    }
+  long bad = fill_matrixn_from_bs(matrix, div_xn, len_gb_xn, start_cf_gb_xn,
+                                  len_xn, lmb, dquot, bs, ht, bexp_lm,
+                                  nv, fc, nthrds);
+  if(bad >= 0){
+    fprintf(stderr, "Staircase is not generic\n");
+    fprintf(stderr, "Multiplication by ");
+    display_monomial_full(stderr, nv, NULL, 0, lmb + bad * nv);
+    fprintf(stderr, " gets outside the staircase\n");
+    free(matrix->dense_mat);
+    free(matrix->dense_idx);
+    free(matrix->triv_idx);
+    free(matrix->triv_pos);
+    free(matrix->dst);
+    free(matrix);
+
+    free(len_gb_xn);
+    free(start_cf_gb_xn);
+    free(div_xn);
+    return NULL;
   }
 
   free(len_gb_xn);
@@ -2744,7 +2952,8 @@ static inline void build_matrixn_from_bs_trace_application(sp_matfglm_t *matrix,
                                                            ht_t *ht,
                                                            int32_t *bexp_lm,
                                                            const int nv,
-                                                           const long fc){
+                                                           const long fc,
+                                                           const int nthrds){
 
 
   long len_xn = matrix->nrows; //get_div_xn(bexp_lm, bs->lml, nv, div_xn);
@@ -2755,6 +2964,8 @@ static inline void build_matrixn_from_bs_trace_application(sp_matfglm_t *matrix,
   long len1 = dquot * matrix->nrows;
   long len2 = dquot - matrix->nrows;
 
+#pragma omp parallel for num_threads(nthrds) \
+  if(nthrds > 1 && !omp_in_parallel())
   for(long i = 0; i < len1; i++){
     matrix->dense_mat[i] = 0;
   }
@@ -2785,85 +2996,26 @@ static inline void build_matrixn_from_bs_trace_application(sp_matfglm_t *matrix,
     }
   }
 
-  long l_triv = 0;
-  long l_dens = 0;
-  long nrows = 0;
-  long count = 0;
-  for(long i = 0; i < dquot; i++){
-
-    long pos = -1;
-    int32_t *exp = lmb + (i * nv);
-#if DEBUGBUILDMATRIX > 0
-    display_monomial_full(stderr, nv, NULL, 0, exp);
-#endif
-    if(member_xxn(exp, lmb + (i * nv), dquot - i, &pos, nv)){
-#if DEBUGBUILDMATRIX > 0
-      fprintf(stderr, " => remains in monomial basis\n");
-#endif
-
-      matrix->triv_idx[l_triv] = i;
-      matrix->triv_pos[l_triv] = pos + i;
-
-      l_triv++;
-    }
-    else{
-
-#if DEBUGBUILDMATRIX > 0
-      fprintf(stderr, " => does NOT remain in monomial basis\n");
-#endif
-      matrix->dense_idx[l_dens] = i;
-      l_dens++;
-      if(is_equal_exponent_xxn(exp, bexp_lm+(div_xn[count])*nv, nv)){
-        copy_poly_in_matrix_from_bs(matrix, nrows, bs, ht, //bcf, bexp, blen,
-                                    div_xn[count], len_gb_xn[count],
-                                    start_cf_gb_xn[count], len_gb_xn[count], lmb,
-                                    nv, fc);
-        nrows++;
-        count++;
-        if(len_xn < count && i < dquot){
-          fprintf(stderr, "One should not arrive here (build_matrix with trace)\n");
-          free(matrix->dense_mat);
-          free(matrix->dense_idx);
-          free(matrix->triv_idx);
-          free(matrix->triv_pos);
-          free(matrix);
-
-          free(len_gb_xn);
-          free(start_cf_gb_xn);
-          free(div_xn);
-          exit(1);
-        }
-      }
-      else{
-        fprintf(stderr, "Staircase is not generic\n");
-        fprintf(stderr, "Multiplication by ");
-        display_monomial_full(stderr, nv, NULL, 0, exp);
-        fprintf(stderr, " gets outside the staircase\n");
-        free(matrix->dense_mat);
-        free(matrix->dense_idx);
-        free(matrix->triv_idx);
-        free(matrix->triv_pos);
-        free(matrix->dst);
-        free(matrix);
-
-        free(len_gb_xn);
-        free(start_cf_gb_xn);
-        free(div_xn);
-        return ;
-        //        exit(1);
-      }
-    }
-  }
-  //Ici on support que les entres de matrix->dst sont initialisees a 0
-  for(long i = 0; i < matrix->nrows; i++){
-    for(long j = matrix->ncols - 1; j >= 0; j--){
-      if(matrix->dense_mat[i*matrix->ncols + j] == 0){
-        matrix->dst[i]++;
-      }
-      else{
-        break;
-      }
-    }
+  long bad = fill_matrixn_from_bs(matrix, div_xn, len_gb_xn, start_cf_gb_xn,
+                                  len_xn, lmb, dquot, bs, ht, bexp_lm,
+                                  nv, fc, nthrds);
+  if(bad >= 0){
+    fprintf(stderr, "Staircase is not generic\n");
+    fprintf(stderr, "Multiplication by ");
+    display_monomial_full(stderr, nv, NULL, 0, lmb + bad * nv);
+    fprintf(stderr, " gets outside the staircase\n");
+    free(matrix->dense_mat);
+    free(matrix->dense_idx);
+    free(matrix->triv_idx);
+    free(matrix->triv_pos);
+    free(matrix->dst);
+    free(matrix);
+
+    free(len_gb_xn);
+    free(start_cf_gb_xn);
+    free(div_xn);
+    return ;
+    //        exit(1);
   }
 }
 
@@ -2877,7 +3029,8 @@ static inline sp_matfglm_t * build_matrixn_from_bs_trace(int32_t **bdiv_xn,
                                                          int32_t *bexp_lm,
                                                          const int nv,
                                                          const long fc,
-                                                         const int info_level){
+                                                         const int info_level,
+                                                         const int nthrds){
 
 
   *bdiv_xn = calloc((unsigned long)bs->lml, sizeof(int32_t));
@@ -2975,96 +3128,176 @@ static inline sp_matfglm_t * build_matrixn_from_bs_trace(int32_t **bdiv_xn,
     }
   }
 
-  long l_triv = 0;
-  long l_dens = 0;
-  long nrows = 0;
-  long count = 0;
+  long bad = fill_matrixn_from_bs(matrix, div_xn, len_gb_xn, start_cf_gb_xn,
+                                  len_xn, lmb, dquot, bs, ht, bexp_lm,
+                                  nv, fc, nthrds);
+  if(bad >= 0){
+    if(info_level){
+      fprintf(stderr, "Staircase is not generic\n");
+      fprintf(stderr, "Multiplication by ");
+      display_monomial_full(stderr, nv, NULL, 0, lmb + bad * nv);
+      fprintf(stderr, " gets outside the staircase\n");
+    }
+    free(matrix->dense_mat);
+    free(matrix->dense_idx);
+    free(matrix->triv_idx);
+    free(matrix->triv_pos);
+    free(matrix->dst);
+    free(matrix);
 
-  for(long i = 0; i < dquot; i++){
-    long pos = -1;
-    int32_t *exp = lmb + (i * nv);
-#if DEBUGBUILDMATRIX > 0
-    display_monomial_full(stderr, nv, NULL, 0, exp);
-    //    fprintf(stderr, "\n");
-#endif
-    if(member_xxn(exp, lmb + (i * nv), dquot - i, &pos, nv)){
-#if DEBUGBUILDMATRIX > 0
-      fprintf(stderr, " => remains in monomial basis\n");
-#endif
+    free(len_gb_xn);
+    free(start_cf_gb_xn);
+    free(div_xn);
+    return NULL;
+  }
 
-      matrix->triv_idx[l_triv] = i;
-      matrix->triv_pos[l_triv] = pos + i;
+  return matrix;
+}
 
-      l_triv++;
-    }
-    else{
-#if DEBUGBUILDMATRIX > 0
-      fprintf(stderr, " => does NOT remain in monomial basis\n");
-#endif
-      int boo = 0;
-      if(count < len_xn){
-        boo = is_equal_exponent_xxn(exp, bexp_lm+(div_xn[count])*nv, nv);
-      }
-      if(boo){
-        matrix->dense_idx[l_dens] = i;
-        l_dens++;
-        copy_poly_in_matrix_from_bs(matrix, nrows, bs, ht,
-                                    div_xn[count], len_gb_xn[count],
-                                    start_cf_gb_xn[count], len_gb_xn[count], lmb,
-                                    nv, fc);
-        nrows++;
-        count++;
 
-        if(len_xn < count && i < dquot){
-          if(info_level){
-            fprintf(stderr, "Staircase is not generic (1 => explain better)\n");
-          }
-          free(matrix->dense_mat);
-          free(matrix->dense_idx);
-          free(matrix->triv_idx);
-          free(matrix->triv_pos);
-          free(matrix->dst);
-          free(matrix);
+/* staircase and index structure of the multiplication matrix, shared by
+   the instances of a batch with the same leading ideal */
+struct sc_t{
+  int32_t *lm; /* exponents of the leading monomials */
+  long nlm;
+  int nv;
+  int32_t *lmb; /* monomial basis */
+  long dquot;
+  int32_t *div_xn;
+  long len_xn;
+  szmat_t *triv_idx;
+  szmat_t *triv_pos;
+  szmat_t *dense_idx;
+};
+
+static void free_staircase_cache(sc_t **scp){
+  sc_t *sc = *scp;
+  if(sc != NULL){
+    free(sc->lm);
+    free(sc->lmb);
+    free(sc->div_xn);
+    free(sc->triv_idx);
+    free(sc->triv_pos);
+    free(sc->dense_idx);
+    free(sc);
+    *scp = NULL;
+  }
+}
 
-          free(len_gb_xn);
-          free(start_cf_gb_xn);
-          free(div_xn);
-          return NULL;
-        }
-      }
-      else{
-        if(info_level){
-          fprintf(stderr, "Staircase is not generic\n");
-          fprintf(stderr, "Multiplication by ");
-          display_monomial_full(stderr, nv, NULL, 0, exp);
-          fprintf(stderr, " gets outside the staircase\n");
-        }
-        free(matrix->dense_mat);
-        free(matrix->dense_idx);
-        free(matrix->triv_idx);
-        free(matrix->triv_pos);
-        free(matrix->dst);
-        free(matrix);
+/* stores copies of the staircase lmb and of the index structure of matrix
+   computed for the leading monomials lm, replacing the ones cached before */
+static void cache_staircase(sc_t *sc, const int32_t *lm, const long nlm,
+                            const int nv, const int32_t *lmb,
+                            const long dquot, const int32_t *div_xn,
+                            const sp_matfglm_t *matrix){
+  const long len_xn = matrix->nrows;
+
+  sc->lm = realloc(sc->lm, sizeof(int32_t) * nlm * nv);
+  memcpy(sc->lm, lm, sizeof(int32_t) * nlm * nv);
+  sc->nlm = nlm;
+  sc->nv = nv;
+  sc->lmb = realloc(sc->lmb, sizeof(int32_t) * dquot * nv);
+  memcpy(sc->lmb, lmb, sizeof(int32_t) * dquot * nv);
+  sc->dquot = dquot;
+  sc->div_xn = realloc(sc->div_xn, sizeof(int32_t) * nlm);
+  memcpy(sc->div_xn, div_xn, sizeof(int32_t) * nlm);
+  sc->len_xn = len_xn;
+  sc->triv_idx = realloc(sc->triv_idx, sizeof(szmat_t) * (dquot - len_xn + 1));
+  memcpy(sc->triv_idx, matrix->triv_idx, sizeof(szmat_t) * (dquot - len_xn));
+  sc->triv_pos = realloc(sc->triv_pos, sizeof(szmat_t) * (dquot - len_xn + 1));
+  memcpy(sc->triv_pos, matrix->triv_pos, sizeof(szmat_t) * (dquot - len_xn));
+  sc->dense_idx = realloc(sc->dense_idx, sizeof(szmat_t) * (len_xn + 1));
+  memcpy(sc->dense_idx, matrix->dense_idx, sizeof(szmat_t) * len_xn);
+}
 
-        free(len_gb_xn);
-        free(start_cf_gb_xn);
-        free(div_xn);
-        return NULL;
-      }
-    }
+/* returns a copy of the cached staircase if it was computed for the
+   leading monomials lm, NULL otherwise */
+static int32_t *staircase_from_cache(const sc_t *sc, const int32_t *lm,
+                                     const long nlm, const int nv,
+                                     long *dquot){
+  if(sc->lmb == NULL || sc->nlm != nlm || sc->nv != nv
+     || memcmp(sc->lm, lm, sizeof(int32_t) * nlm * nv) != 0){
+    return NULL;
   }
+  int32_t *lmb = malloc(sizeof(int32_t) * sc->dquot * nv);
+  memcpy(lmb, sc->lmb, sizeof(int32_t) * sc->dquot * nv);
+  *dquot = sc->dquot;
+  return lmb;
+}
 
-  for(long i = 0; i < matrix->nrows; i++){
-    for(long j = matrix->ncols - 1; j >= 0; j--){
-      if(matrix->dense_mat[i*matrix->ncols + j] == 0){
-        matrix->dst[i]++;
-      }
-      else{
-        break;
-      }
+/* same as build_matrixn_from_bs_trace but the index structure of the
+   matrix is taken from the cache sc, only the coefficients are read
+   from bs. the leading monomials of bs must be the cached ones. */
+static inline sp_matfglm_t * build_matrixn_from_bs_cached(int32_t **bdiv_xn,
+                                                          int32_t **blen_gb_xn,
+                                                          int32_t **bstart_cf_gb_xn,
+                                                          const sc_t *sc,
+                                                          bs_t *bs,
+                                                          ht_t *ht,
+                                                          const long fc,
+                                                          const int nthrds){
+  const long dquot = sc->dquot;
+  const long len_xn = sc->len_xn;
+
+  *bdiv_xn = malloc(sizeof(int32_t) * bs->lml);
+  memcpy(*bdiv_xn, sc->div_xn, sizeof(int32_t) * bs->lml);
+  int32_t *div_xn = *bdiv_xn;
+
+  *blen_gb_xn = malloc(sizeof(int32_t) * len_xn);
+  int32_t *len_gb_xn = *blen_gb_xn;
+
+  *bstart_cf_gb_xn = malloc(sizeof(int32_t) * len_xn);
+  int32_t *start_cf_gb_xn = *bstart_cf_gb_xn;
+
+  long pos = 0, k = 0;
+  for(long i = 0; i < bs->lml; i++){
+    long len = bs->hm[bs->lmps[i]][LENGTH];
+    if(i==div_xn[k]){
+      len_gb_xn[k]=len;
+      start_cf_gb_xn[k]=pos;
+      pos+=len;
+      k++;
     }
+    else{
+      pos+=len;
+    }
+  }
+
+  sp_matfglm_t *matrix ALIGNED32 = calloc(1, sizeof(sp_matfglm_t));
+  matrix->charac = fc;
+  matrix->ncols = dquot;
+  matrix->nrows = len_xn;
+  long len1 = dquot * len_xn;
+  long len2 = dquot - len_xn;
+
+  if(posix_memalign((void **)&matrix->dense_mat, 32, sizeof(CF_t)*len1)){
+    fprintf(stderr, "Problem when allocating matrix->dense_mat\n");
+    exit(1);
+  }
+  memset(matrix->dense_mat, 0, sizeof(CF_t)*len1);
+  if(posix_memalign((void **)&matrix->triv_idx, 32, sizeof(CF_t)*len2)){
+    fprintf(stderr, "Problem when allocating matrix->triv_idx\n");
+    exit(1);
+  }
+  memcpy(matrix->triv_idx, sc->triv_idx, sizeof(szmat_t)*len2);
+  if(posix_memalign((void **)&matrix->triv_pos, 32, sizeof(CF_t)*len2)){
+    fprintf(stderr, "Problem when allocating matrix->triv_pos\n");
+    exit(1);
+  }
+  memcpy(matrix->triv_pos, sc->triv_pos, sizeof(szmat_t)*len2);
+  if(posix_memalign((void **)&matrix->dense_idx, 32, sizeof(CF_t)*len_xn)){
+    fprintf(stderr, "Problem when allocating matrix->dense_idx\n");
+    exit(1);
+  }
+  memcpy(matrix->dense_idx, sc->dense_idx, sizeof(szmat_t)*len_xn);
+  if(posix_memalign((void **)&matrix->dst, 32, sizeof(CF_t)*len_xn)){
+    fprintf(stderr, "Problem when allocating matrix->dst\n");
+    exit(1);
   }
 
+  fill_matrixn_coefficients_from_bs(matrix, div_xn, len_gb_xn, start_cf_gb_xn,
+                                    len_xn, sc->lmb, bs, ht, sc->nv, fc,
+                                    nthrds);
   return matrix;
 }
 
@@ -18,6 +18,10 @@
  * Christian Eder
  * Mohab Safey El Din */
 
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+
 static inline void store_exponent(const char *term, data_gens_ff_t *gens, int32_t pos)
 {
   nvars_t k;
@@ -900,10 +904,371 @@ static int duplicate_vnames(char **vnames, int32_t nvars) {
   return 0;
 }
 
+/* Fast path for get_data_from_file: the file is mapped in memory and read
+ * once. Terms are tokenized in place, generators (separated by commas) are
+ * parsed in parallel. Returns 1 without setting anything when the file
+ * cannot be mapped or uses a syntax this reader does not handle; the
+ * getline based reader is used then. */
+
+static inline const char *skip_spaces(const char *s, const char *e){
+  while(s < e && isspace((unsigned char)*s)){
+    s++;
+  }
+  return s;
+}
+
+static inline int is_name_char(const char c){
+  return !isspace((unsigned char)c) && c != '*' && c != '^' && c != '+'
+    && c != '-' && c != ',' && c != '/';
+}
+
+/* copies the digits starting at *s (white spaces are skipped) into buf,
+ * returns the number of digits */
+static inline long copy_digits(const char **s, const char *e, char *buf){
+  long n = 0;
+  const char *c = skip_spaces(*s, e);
+  while(c < e && (isdigit((unsigned char)*c) || isspace((unsigned char)*c))){
+    if(isdigit((unsigned char)*c)){
+      buf[n++] = *c;
+    }
+    c++;
+  }
+  buf[n] = '\0';
+  *s = c;
+  return n;
+}
+
+static inline long get_nterms_from_slice(const char *b, const char *e){
+  long nterms = 1;
+  b = skip_spaces(b, e);
+  if(b < e && (*b == '-' || *b == '+')){
+    nterms--;
+  }
+  for(const char *c = b; c < e; c++){
+    nterms += (*c == '+' || *c == '-');
+  }
+  return nterms;
+}
+
+/* parses the generator in [b, e) with nterms terms, its first term is
+ * stored at position pos, buf has at least e - b + 2 chars.
+ * returns 1 on unsupported syntax */
+static int get_generator_from_slice(const char *b, const char *e,
+                                    const long nterms, const long pos,
+                                    char **vnames, const size_t *vlens,
+                                    char *buf, data_gens_ff_t *gens){
+  const int32_t nv = gens->nvars;
+  const char *c = b;
+  long t = 0;
+  while(1){
+    c = skip_spaces(c, e);
+    if(c == e){
+      break;
+    }
+    if(t == nterms){
+      return 1;
+    }
+    int sign = 1;
+    if(*c == '+' || *c == '-'){
+      sign = (*c == '-') ? -1 : 1;
+      c = skip_spaces(c + 1, e);
+    }
+    int32_t *exp = gens->exps + (pos + t) * nv;
+    int has_cf = 0;
+    int nfactors = 0;
+    while(1){
+      c = skip_spaces(c, e);
+      if(c == e){
+        return 1;
+      }
+      if(isdigit((unsigned char)*c)){
+        if(nfactors > 0){
+          return 1;
+        }
+        buf[0] = (sign < 0) ? '-' : '+';
+        copy_digits(&c, e, buf + 1);
+        if(gens->field_char){
+          c = skip_spaces(c, e);
+          if(c < e && *c == '/'){
+            return 1;
+          }
+          int32_t cf = (int32_t)strtol(buf, NULL, 10);
+          /* zero coefficients are left to the stream based reader */
+          if(cf == 0){
+            return 1;
+          }
+          while(cf < 0){
+            cf += gens->field_char;
+          }
+          gens->cfs[pos + t] = cf;
+        }
+        else{
+          mpz_set_str(*(gens->mpz_cfs[2*(pos + t)]), buf + 1, 10);
+          if(sign < 0){
+            mpz_neg(*(gens->mpz_cfs[2*(pos + t)]),
+                    *(gens->mpz_cfs[2*(pos + t)]));
+          }
+          c = skip_spaces(c, e);
+          if(c < e && *c == '/'){
+            c++;
+            if(copy_digits(&c, e, buf) == 0){
+              return 1;
+            }
+            mpz_set_str(*(gens->mpz_cfs[2*(pos + t) + 1]), buf, 10);
+          }
+          else{
+            mpz_set_ui(*(gens->mpz_cfs[2*(pos + t) + 1]), 1);
+          }
+        }
+        has_cf = 1;
+      }
+      else{
+        const char *n = c;
+        while(c < e && is_name_char(*c)){
+          c++;
+        }
+        const size_t len = c - n;
+        int32_t k = 0;
+        while(k < nv && (vlens[k] != len || strncmp(vnames[k], n, len))){
+          k++;
+        }
+        /* a repeated variable is left to the stream based reader */
+        if(len == 0 || k == nv || exp[k] != 0){
+          return 1;
+        }
+        int32_t d = 1;
+        c = skip_spaces(c, e);
+        if(c < e && *c == '^'){
+          c++;
+          if(copy_digits(&c, e, buf) == 0){
+            return 1;
+          }
+          d = strtol(buf, NULL, 10);
+        }
+        exp[k] = d;
+      }
+      nfactors++;
+      c = skip_spaces(c, e);
+      if(c < e && *c == '*'){
+        c++;
+        continue;
+      }
+      break;
+    }
+    if(c < e && *c != '+' && *c != '-'){
+      return 1;
+    }
+    if(!has_cf){
+      if(gens->field_char){
+        gens->cfs[pos + t] = (sign < 0) ? gens->field_char - 1 : 1;
+      }
+      else{
+        mpz_set_si(*(gens->mpz_cfs[2*(pos + t)]), sign);
+        mpz_set_ui(*(gens->mpz_cfs[2*(pos + t) + 1]), 1);
+      }
+    }
+    t++;
+  }
+  return (t != nterms);
+}
+
+static int get_data_from_mapped_file(char *fn, int32_t *nr_vars,
+                                     int32_t *field_char,
+                                     int32_t *nr_gens, data_gens_ff_t *gens,
+                                     const int nthrds){
+  int fd = open(fn, O_RDONLY);
+  if(fd < 0){
+    return 1;
+  }
+  struct stat sb;
+  if(fstat(fd, &sb) != 0 || sb.st_size == 0){
+    close(fd);
+    return 1;
+  }
+  const size_t size = sb.st_size;
+  char *data = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if(data == MAP_FAILED){
+    return 1;
+  }
+  const char *end = data + size;
+
+  /* first line are the variables, second line is the characteristic */
+  const char *l1 = memchr(data, '\n', size);
+  const char *l2 = (l1 == NULL) ? NULL : memchr(l1 + 1, '\n', end - l1 - 1);
+  if(l2 == NULL){
+    munmap(data, size);
+    return 1;
+  }
+  char buf[64];
+  size_t clen = l2 - l1 - 1;
+  if(clen > sizeof(buf) - 1){
+    clen = sizeof(buf) - 1;
+  }
+  memcpy(buf, l1 + 1, clen);
+  buf[clen] = '\0';
+  const int64_t fc = atol(buf);
+  if(fc < 0 || fc > 2147483647){
+    munmap(data, size);
+    return 1;
+  }
+
+  int32_t nvars = 0;
+  char **vnames = malloc((l1 - data + 1) * sizeof(char *));
+  for(const char *v = data; v < l1; ){
+    const char *w = memchr(v, ',', l1 - v);
+    if(w == NULL){
+      w = l1;
+    }
+    const char *vb = skip_spaces(v, w);
+    const char *ve = w;
+    while(ve > vb && isspace((unsigned char)ve[-1])){
+      ve--;
+    }
+    if(vb == ve){
+      /* a trailing comma does not give another variable */
+      if(w != l1 && skip_spaces(w + 1, l1) != l1){
+        nvars = -1;
+        break;
+      }
+    }
+    else{
+      vnames[nvars] = strndup(vb, ve - vb);
+      nvars++;
+    }
+    v = w + 1;
+  }
+  if(nvars <= 0){
+    for(int32_t i = 0; i < nvars; i++){
+      free(vnames[i]);
+    }
+    free(vnames);
+    munmap(data, size);
+    return 1;
+  }
+
+  /* generators */
+  long ngens = 0, alloc = 64;
+  const char **gb = malloc(alloc * sizeof(char *));
+  const char **ge = malloc(alloc * sizeof(char *));
+  for(const char *g = l2 + 1; g < end; ){
+    const char *w = memchr(g, ',', end - g);
+    if(w == NULL){
+      w = end;
+    }
+    if(skip_spaces(g, w) != w){
+      if(ngens == alloc){
+        alloc *= 2;
+        gb = realloc(gb, alloc * sizeof(char *));
+        ge = realloc(ge, alloc * sizeof(char *));
+      }
+      gb[ngens] = g;
+      ge[ngens] = w;
+      ngens++;
+    }
+    g = w + 1;
+  }
+
+  if(ngens == 0){
+    for(int32_t i = 0; i < nvars; i++){
+      free(vnames[i]);
+    }
+    free(vnames);
+    free(gb);
+    free(ge);
+    munmap(data, size);
+    return 1;
+  }
+
+  if(duplicate_vnames(vnames, nvars) == 1){
+    free(vnames);
+    exit(1);
+  }
+
+  *nr_vars = nvars;
+  *nr_gens = ngens;
+  *field_char = fc;
+  gens->vnames = vnames;
+  initialize_data_gens(nvars, ngens, fc, gens);
+
+  size_t *vlens = malloc(nvars * sizeof(size_t));
+  for(int32_t i = 0; i < nvars; i++){
+    vlens[i] = strlen(vnames[i]);
+  }
+
+  long *start = malloc((ngens + 1) * sizeof(long));
+#pragma omp parallel for num_threads(nthrds) if(nthrds > 1)
+  for(long i = 0; i < ngens; i++){
+    gens->lens[i] = get_nterms_from_slice(gb[i], ge[i]);
+  }
+  start[0] = 0;
+  for(long i = 0; i < ngens; i++){
+    start[i+1] = start[i] + gens->lens[i];
+  }
+  const long all_nterms = start[ngens];
+  gens->nterms = all_nterms;
+
+  gens->cfs = (int32_t *)malloc(sizeof(int32_t) * all_nterms);
+  gens->exps = (int32_t *)calloc(all_nterms * nvars, sizeof(int32_t));
+  if(fc == 0){
+    gens->mpz_cfs = (mpz_t **)malloc(sizeof(mpz_t *) * 2 * all_nterms);
+  }
+
+  int bad = 0;
+#pragma omp parallel for num_threads(nthrds) schedule(dynamic) if(nthrds > 1)
+  for(long i = 0; i < ngens; i++){
+    if(fc == 0){
+      for(long j = 2 * start[i]; j < 2 * start[i+1]; j++){
+        gens->mpz_cfs[j] = (mpz_t *)malloc(sizeof(mpz_t));
+        mpz_init(*(gens->mpz_cfs[j]));
+      }
+    }
+    char *tbuf = malloc((ge[i] - gb[i] + 2) * sizeof(char));
+    if(get_generator_from_slice(gb[i], ge[i], gens->lens[i], start[i],
+                                vnames, vlens, tbuf, gens)){
+#pragma omp atomic write
+      bad = 1;
+    }
+    free(tbuf);
+  }
+
+  free(vlens);
+  free(start);
+  free(gb);
+  free(ge);
+  munmap(data, size);
+
+  if(bad){
+    /* leaves the data as before the call */
+    if(fc == 0){
+      for(long i = 0; i < 2 * all_nterms; i++){
+        mpz_clear(*(gens->mpz_cfs[i]));
+        free(gens->mpz_cfs[i]);
+      }
+      free(gens->mpz_cfs);
+    }
+    free(gens->cfs);
+    free(gens->exps);
+    free(gens->lens);
+    for(int32_t i = 0; i < nvars; i++){
+      free(vnames[i]);
+    }
+    free(vnames);
+    gens->vnames = NULL;
+    return 1;
+  }
+  return 0;
+}
+
 //nr_gens is a pointer to the number of generators
 static inline void get_data_from_file(char *fn, int32_t *nr_vars,
                                       int32_t *field_char,
-                                      int32_t *nr_gens, data_gens_ff_t *gens){
+                                      int32_t *nr_gens, data_gens_ff_t *gens,
+                                      const int nthrds){
+  if(get_data_from_mapped_file(fn, nr_vars, field_char, nr_gens,
+                               gens, nthrds) == 0){
+    return;
+  }
   *nr_vars = get_nvars(fn);
   *nr_gens = get_ngenerators(fn);
 
@@ -1140,6 +1505,49 @@ static inline void get_params_from_file_bin(char *fn, mpz_param_array_t lparam){
   fclose(file);
 }
 
+/* reads the next univariate polynomial of a stream of polynomials, encoded
+ * as in get_poly (bin = 0) or get_poly_bin (bin = 1).
+ * returns 0 when the end of the stream is reached, 1 otherwise. */
+static inline int get_next_poly_from_stream(FILE *file, mpz_upoly_t pol,
+                                            const int bin){
+  int32_t len = 0;
+  int r = fscanf(file, "%d", &len);
+  if(r == EOF){
+    return 0;
+  }
+  if(r != 1 || len < 0){
+    fprintf(stderr, "Issue when reading polynomial stream (length)\n");
+    exit(1);
+  }
+  if(bin){
+    /* skips the end of line before raw data */
+    if(fgetc(file) != '\n'){
+      fprintf(stderr, "Issue when reading polynomial stream (length)\n");
+      exit(1);
+    }
+  }
+  if(len > pol->alloc){
+    pol->coeffs = realloc(pol->coeffs, sizeof(mpz_t) * len);
+    for(int32_t i = pol->alloc; i < len; i++){
+      mpz_init(pol->coeffs[i]);
+    }
+    pol->alloc = len;
+  }
+  pol->length = len;
+  for(int32_t i = 0; i < len; i++){
+    if((bin && !mpz_inp_raw(pol->coeffs[i], file)) ||
+       (!bin && !mpz_inp_str(pol->coeffs[i], file, 10))){
+      fprintf(stderr, "An error occurred when reading polynomial stream (i=%d)\n", i);
+      exit(1);
+    }
+  }
+  /* removes leading zero coefficients */
+  while(pol->length > 0 && mpz_sgn(pol->coeffs[pol->length - 1]) == 0){
+    pol->length--;
+  }
+  return 1;
+}
+
 static inline void get_params_from_file(char *fn, mpz_param_array_t lparam){
   FILE *file = fopen(fn,"r");
   int32_t nb = 0;
@@ -24,8 +24,8 @@
 
 typedef struct{
   uint32_t len; /* length of the encoded polynomial */
-  uint32_t **cf_32; /* array of arrays of coefficients
-                       * modulo several primes
+  uint64_t **cf_64; /* array of arrays of coefficients
+                       * modulo several primes (31 or 62 bits)
                        */
   mpz_t *cf_zz; /* array which stores CRT lifting of
                     the coefficiels */
@@ -176,11 +176,11 @@ static inline void gb_modpoly_init(gb_modpoly_t modgbs,
   }
   for(uint32_t i = 0; i < ld; i++){
     modgbs->modpolys[i]->len = lens[i];
-    modgbs->modpolys[i]->cf_32 = malloc(sizeof(uint32_t **)*lens[i]);
+    modgbs->modpolys[i]->cf_64 = malloc(sizeof(uint64_t *)*lens[i]);
     modgbs->modpolys[i]->cf_zz = malloc(sizeof(mpz_t)*lens[i]);
     modgbs->modpolys[i]->cf_qq = malloc(sizeof(mpz_t)*2*lens[i]);
     for(uint32_t j = 0; j < lens[i]; j++){
-      modgbs->modpolys[i]->cf_32[j] = calloc(sizeof(uint32_t), alloc);
+      modgbs->modpolys[i]->cf_64[j] = calloc(sizeof(uint64_t), alloc);
       mpz_init(modgbs->modpolys[i]->cf_zz[j]);
     }
     for(uint32_t j = 0; j < 2 * lens[i]; j++){
@@ -223,21 +223,21 @@ static inline void gb_modpoly_realloc(gb_modpoly_t modgbs,
   }
   for(uint32_t i = start; i < modgbs->ld; i++){
     for(uint32_t j = 0; j < modgbs->modpolys[i]->len; j++){
-      uint32_t *newcfs_pol = (uint32_t *)realloc(modgbs->modpolys[i]->cf_32[j],
-                                                 modgbs->alloc * sizeof(uint32_t));
+      uint64_t *newcfs_pol = (uint64_t *)realloc(modgbs->modpolys[i]->cf_64[j],
+                                                 modgbs->alloc * sizeof(uint64_t));
       if(newcfs_pol == NULL){
         fprintf(stderr, "Problem when reallocating modgbs (cfs_pol)\n");
       }
-      modgbs->modpolys[i]->cf_32[j] = newcfs_pol;
+      modgbs->modpolys[i]->cf_64[j] = newcfs_pol;
       for(uint32_t k = oldalloc; k < modgbs->alloc; k++){
-        modgbs->modpolys[i]->cf_32[j][k] = 0;
+        modgbs->modpolys[i]->cf_64[j][k] = 0;
       }
     }
   }
 }
 
 
-static inline void display_gbmodpoly_cf_32(FILE *file,
+static inline void display_gbmodpoly_cf_64(FILE *file,
                                      gb_modpoly_t modgbs){
   fprintf(file, "alloc = %d\n", modgbs->alloc);
   fprintf(file, "nprimes = %d\n", modgbs->nprimes);
@@ -254,13 +254,13 @@ static inline void display_gbmodpoly_cf_32(FILE *file,
     for(uint32_t j = 0; j < len; j++){
       fprintf(stderr, "[");
       for(uint32_t k = 0; k < modgbs->alloc-1; k++){
-        fprintf(file, "%d, ", modgbs->modpolys[i]->cf_32[j][k]);
+        fprintf(file, "%lu, ", (unsigned long)modgbs->modpolys[i]->cf_64[j][k]);
       }
       if(j < len - 1){
-        fprintf(file, "%d], ", modgbs->modpolys[i]->cf_32[j][modgbs->alloc-1]);
+        fprintf(file, "%lu], ", (unsigned long)modgbs->modpolys[i]->cf_64[j][modgbs->alloc-1]);
       }
       else{
-        fprintf(file, "%d]\n", modgbs->modpolys[i]->cf_32[j][modgbs->alloc-1]);
+        fprintf(file, "%lu]\n", (unsigned long)modgbs->modpolys[i]->cf_64[j][modgbs->alloc-1]);
       }
     }
     fprintf(file, "],\n");
@@ -366,14 +366,14 @@ static inline void gb_modpoly_clear(gb_modpoly_t modgbs){
   free(modgbs->ldm);
   for(uint32_t i = 0; i < modgbs->ld; i++){
     for(uint32_t j = 0; j < modgbs->modpolys[i]->len; j++){
-      free(modgbs->modpolys[i]->cf_32[j]);
+      free(modgbs->modpolys[i]->cf_64[j]);
       mpz_clear(modgbs->modpolys[i]->cf_zz[j]);
     }
     for(uint32_t j = 0; j < 2 * modgbs->modpolys[i]->len; j++){
       mpz_clear(modgbs->modpolys[i]->cf_qq[j]);
     }
     mpz_clear(modgbs->modpolys[i]->lm);
-    free(modgbs->modpolys[i]->cf_32);
+    free(modgbs->modpolys[i]->cf_64);
     free(modgbs->modpolys[i]->cf_zz);
     free(modgbs->modpolys[i]->cf_qq);
   }
@@ -480,7 +480,7 @@ static inline int32_t *array_of_lengths(int32_t *bexp_lm, int len,
 /* returns 0 in case of failure else returns 1 */
 static inline int modpgbs_set(gb_modpoly_t modgbs,
                               const bs_t *bs, const ht_t * const ht,
-                              const int32_t fc,
+                              const uint64_t fc,
                               int32_t *basis, const int dquot,
                               int *mgb, int32_t start, const long elim){
   if(modgbs->nprimes >= modgbs->alloc-1){
@@ -522,14 +522,16 @@ static inline int modpgbs_set(gb_modpoly_t modgbs,
     }
     int bc = modgbs->modpolys[i]->len - 1;
     for (j = 1; j < len; ++j) {
-      uint32_t c = bs->cf_32[bs->hm[idx][COEFFS]][j];
+      /* 62 bit primes come with 64 bit coefficients in neogb */
+      uint64_t c = bs->cf_64 != NULL ?
+        bs->cf_64[bs->hm[idx][COEFFS]][j] : bs->cf_32[bs->hm[idx][COEFFS]][j];
       for (k = 0; k < nv; ++k) {
           mgb[k] = ht->ev[hm[j]][evi[k]];
       }
       while(!is_equal_exponent_elim(mgb, basis + (bc * (nv - elim)), nv, elim)){
         bc--;
       }
-      modgbs->modpolys[i]->cf_32[bc][modgbs->nprimes] = c;
+      modgbs->modpolys[i]->cf_64[bc][modgbs->nprimes] = c;
       bc--;
     }
   }
@@ -581,7 +583,7 @@ static int32_t * gb_modular_trace_learning(gb_modpoly_t modgbs,
                                            bs_t *bs_qq,
                                            ht_t *bht,
                                            md_t *st,
-                                           const int32_t fc,
+                                           const uint64_t fc,
                                            int info_level,
                                            int print_gb,
                                            int *dim,
@@ -710,7 +712,7 @@ static void gb_modular_trace_application(gb_modpoly_t modgbs,
                                          bs_t *bs_qq,
                                          ht_t **bht,
                                          md_t *st,
-                                         const int32_t fc,
+                                         const uint64_t fc,
                                          int info_level,
                                          bs_t **obs,
                                          int32_t *lmb_ori,
@@ -793,7 +795,7 @@ static inline void choose_coef_to_lift(gb_modpoly_t modgbs, data_lift_t dlift){
     uint32_t d = 0;
     uint32_t len = modgbs->modpolys[i]->len;
     while(d < len - 1){
-      if(modgbs->modpolys[i]->cf_32[d][0]){
+      if(modgbs->modpolys[i]->cf_64[d][0]){
         dlift->coef[i] = d;
         break;
       }
@@ -814,7 +816,7 @@ static inline void incremental_dlift_crt(gb_modpoly_t modgbs, data_lift_t dlift,
   /* all primes are assumed to be good primes */
   mpz_mul_ui(prod_p[0], mod_p[0], modgbs->primes[modgbs->nprimes - 1 ]);
   for(int32_t k = dlift->lstart; k <= dlift->lend; k++){
-    uint32_t c = modgbs->modpolys[k]->cf_32[coef[k]][modgbs->nprimes  - 1 ];
+    uint64_t c = modgbs->modpolys[k]->cf_64[coef[k]][modgbs->nprimes  - 1 ];
     mpz_CRT_ui(dlift->crt[k], dlift->crt[k], mod_p[0],
                c, modgbs->primes[modgbs->nprimes - 1 ],
                prod_p[0], dlift->tmp, 1);
@@ -832,9 +834,9 @@ static inline void incremental_dlift_crt_full(gb_modpoly_t modgbs, data_lift_t d
   uint64_t newprime = modgbs->primes[modgbs->nprimes - 1 ];
 
   /* all primes are assumed to be good primes */
-  mpz_mul_ui(prod_p, mod_p, (uint32_t)newprime);
+  mpz_mul_ui(prod_p, mod_p, newprime);
   for(int32_t k = dl->lstart; k < modgbs->ld; k++){
-    uint64_t c = modgbs->modpolys[k]->cf_32[coef[k]][modgbs->nprimes  - 1 ];
+    uint64_t c = modgbs->modpolys[k]->cf_64[coef[k]][modgbs->nprimes  - 1 ];
 
     mpz_CRT_ui(dl->crt[k], dl->crt[k], mod_p,
                c, newprime, prod_p, dl->tmp, 1);
@@ -861,7 +863,7 @@ static inline void crt_lift_modgbs(gb_modpoly_t modgbs, data_lift_t dlift,
     if(dlift->check1[k]){
       for(int32_t l = 0; l < polys[k]->len; l++){
         for(uint32_t i = 0; i < modgbs->nprimes-1; i++){
-          modgbs->cf_64[i] = polys[k]->cf_32[l][i];
+          modgbs->cf_64[i] = polys[k]->cf_64[l][i];
         }
         fmpz_multi_CRT_ui(y, modgbs->cf_64,
                           comb, comb_temp, 1);
@@ -955,13 +957,12 @@ static inline int ratrecon_lift_modgbs(gb_modpoly_t modgbs, data_lift_t dl,
 
 
 /* returns (coef == num / den mod prime) */
-static inline int verif_coef(mpz_t num, mpz_t den, uint32_t prime, uint32_t coef){
-  uint32_t lc = mpz_fdiv_ui(den, prime);
-  lc = mod_p_inverse_32(lc, prime);
+static inline int verif_coef(mpz_t num, mpz_t den, uint64_t prime, uint64_t coef){
+  uint64_t lc = mpz_fdiv_ui(den, prime);
+  lc = mod_p_inverse_64(lc, prime);
 
   uint64_t c = mpz_fdiv_ui(num, prime);
-  c *= lc;
-  c = c % prime;
+  c = mod_p_mul_64(c, lc, prime);
 
   return (c==coef);
 }
@@ -975,8 +976,8 @@ static inline int verif_lifted_rational_wcoef(gb_modpoly_t modgbs, data_lift_t d
     }
     for(int i = 0; i < thrds; i++){
 
-      uint32_t prime = modgbs->primes[modgbs->nprimes - (thrds - i) ];
-      uint32_t coef = modgbs->modpolys[k]->cf_32[dl->coef[k]][modgbs->nprimes  - (thrds - i) ];
+      uint64_t prime = modgbs->primes[modgbs->nprimes - (thrds - i) ];
+      uint64_t coef = modgbs->modpolys[k]->cf_64[dl->coef[k]][modgbs->nprimes  - (thrds - i) ];
       int b = verif_coef(dl->num[k], dl->den[k], prime, coef);
 
       if(!b){
@@ -1080,6 +1081,31 @@ long max_bit_size_gb(gb_modpoly_t modgbs){
 
 
 
+/* primes used for the multi-modular computation: 31 bit primes are taken
+ * close to 2^30, 62 bit primes close to 2^62 (the 64 bit linear algebra of
+ * neogb needs p < 2^63) */
+static inline uint64_t prime_start_bits(const int32_t prime_bits){
+  if(prime_bits > 31){
+    return (uint64_t)1<<62;
+  }
+  return (uint64_t)1<<30;
+}
+
+static inline uint64_t random_prime_start(const int32_t prime_bits){
+  if(prime_bits > 31){
+    return prime_start_bits(prime_bits) + ((uint64_t)rand() << 20);
+  }
+  return rand() % (1303905301 - (1<<30) + 1) + (1<<30);
+}
+
+static inline uint64_t next_modular_prime(const uint64_t prime,
+                                          const int32_t prime_bits){
+  if(prime_bits > 31){
+    return next_prime_64(prime);
+  }
+  return next_prime(prime);
+}
+
 /*
 
   - renvoie 0 si le calcul est ok.
@@ -1119,6 +1145,7 @@ int msolve_gbtrace_qq(
   int32_t info_level = flags->info_level;
   int32_t pbm_file = flags->pbm_file;
   int32_t print_gb = flags->print_gb;
+  int32_t prime_bits = flags->prime_bits;
   files_gb *files = flags->files;
 
   uint32_t field_char = gens->field_char;
@@ -1189,17 +1216,17 @@ int msolve_gbtrace_qq(
   else{
     msd->lp->old = 0;
     msd->lp->ld = 1;
-    msd->lp->p = calloc(1, sizeof(uint32_t));
+    msd->lp->p = calloc(1, sizeof(uint64_t));
     normalize_initial_basis(msd->bs_qq, st->gfc);
   }
 
-  uint32_t prime = next_prime(1<<30);
-  uint32_t primeinit;
+  uint64_t prime = next_modular_prime(prime_start_bits(prime_bits), prime_bits);
+  uint64_t primeinit;
   srand(time(0));
 
-  prime = next_prime(rand() % (1303905301 - (1<<30) + 1) + (1<<30));
+  prime = next_modular_prime(random_prime_start(prime_bits), prime_bits);
   while(gens->field_char==0 && is_lucky_prime_ui(prime, msd->bs_qq)){
-    prime = next_prime(rand() % (1303905301 - (1<<30) + 1) + (1<<30));
+    prime = next_modular_prime(random_prime_start(prime_bits), prime_bits);
   }
 
   primeinit = prime;
@@ -1208,7 +1235,7 @@ int msolve_gbtrace_qq(
     msd->lp->p[0] = gens->field_char;
     primeinit = gens->field_char;
   }
-  prime = next_prime(1<<30);
+  prime = next_modular_prime(prime_start_bits(prime_bits), prime_bits);
 
   int success = 1;
 
@@ -1259,7 +1286,7 @@ int msolve_gbtrace_qq(
     gb_modpoly_realloc(modgbs, 1, dlift->S);
 
 #ifdef DEBUGGBLIFT
-    display_gbmodpoly_cf_32(stderr, modgbs);
+    display_gbmodpoly_cf_64(stderr, modgbs);
 #endif
 
     if(!dlinit){
@@ -1320,18 +1347,18 @@ int msolve_gbtrace_qq(
     while(apply){
 
       /* generate lucky prime numbers */
-      msd->lp->p[0] = next_prime(prime);
+      msd->lp->p[0] = next_modular_prime(prime, prime_bits);
       while(is_lucky_prime_ui(prime, msd->bs_qq) || prime==primeinit){
-        prime = next_prime(prime);
+        prime = next_modular_prime(prime, prime_bits);
         msd->lp->p[0] = prime;
       }
 
       int nthrds = 1; /* mono-threaded mult-mid comp */
       for(len_t i = 1; i < nthrds/* st->nthrds */; i++){
-        prime = next_prime(prime);
+        prime = next_modular_prime(prime, prime_bits);
         msd->lp->p[i] = prime;
         while(is_lucky_prime_ui(prime, msd->bs_qq) || prime==primeinit){
-          prime = next_prime(prime);
+          prime = next_modular_prime(prime, prime_bits);
           msd->lp->p[i] = prime;
         }
       }
@@ -63,6 +63,18 @@ static inline void display_help(char *str){
 
 
   fprintf(stdout, "\nAdvanced options:\n\n");
+  fprintf(stdout, "-b LIST  Batch mode: each line of LIST gives the names of\n");
+  fprintf(stdout, "         an input and an output file, all instances are\n");
+  fprintf(stdout, "         solved in one run. Systems over the rationals\n");
+  fprintf(stdout, "         with the same support share one tracer, so\n");
+  fprintf(stdout, "         only the first one runs the learning phase.\n");
+  fprintf(stdout, "-B BITS  Bit size of the primes used for multi-modular\n");
+  fprintf(stdout, "         Groebner basis computations over the rationals\n");
+  fprintf(stdout, "         (with -g 2), each prime gives twice as many bits\n");
+  fprintf(stdout, "         with 62 bit primes.\n");
+  fprintf(stdout, "         31 - 31 bit primes (default).\n");
+  fprintf(stdout, "         62 - 62 bit primes.\n");
+  fprintf(stdout, "         Solving via FGLM always uses 31 bit primes.\n");
   fprintf(stdout, "-F FILE  File name encoding parametrizations in binary format.\n\n");
   fprintf(stdout, "-g GB    Prints reduced Groebner bases of input system for\n");
   fprintf(stdout, "         first prime characteristic w.r.t. grevlex ordering.\n");
@@ -89,9 +101,17 @@ static inline void display_help(char *str){
   fprintf(stdout, "         monomial order. ELIM has to be a number between\n");
   fprintf(stdout, "         1 and #variables-1. The basis the first block eliminated\n");
   fprintf(stdout, "         is then computed.\n");
-  fprintf(stdout, "-I       Isolates the real roots (provided some univariate data)\n");
+  fprintf(stdout, "-I ISO   Isolates the real roots (provided some univariate data)\n");
   fprintf(stdout, "         without re-computing a Gröbner basis\n");
-  fprintf(stdout, "         Default: 0 (no).\n");
+  fprintf(stdout, "         0 - no (default).\n");
+  fprintf(stdout, "         1 - parametrizations given in FILE.\n");
+  fprintf(stdout, "         2 - stream of univariate polynomials given in FILE\n");
+  fprintf(stdout, "             (text with -f, binary with -F, '-' for stdin),\n");
+  fprintf(stdout, "             each polynomial is given by its number of\n");
+  fprintf(stdout, "             coefficients followed by its coefficients in\n");
+  fprintf(stdout, "             increasing degree. Polynomials are isolated in\n");
+  fprintf(stdout, "             parallel and their roots are printed one line per\n");
+  fprintf(stdout, "             polynomial in input order.\n");
   fprintf(stdout, "-l LIN   Linear algebra variant to be applied:\n");
   fprintf(stdout, "          1 - exact sparse / dense\n");
   fprintf(stdout, "          2 - exact sparse (default)\n");
@@ -106,6 +126,9 @@ static inline void display_help(char *str){
   fprintf(stdout, "         format please see the general output data format section\n");
   fprintf(stdout, "         above.\n");
   fprintf(stdout, "-q Q     Uses signature-based algorithms.\n");
+  fprintf(stdout, "         Only available for homogeneous input over prime\n");
+  fprintf(stdout, "         fields, only the Groebner basis is computed,\n");
+  fprintf(stdout, "         it is printed with -g.\n");
   fprintf(stdout, "         Default: 0 (no).\n");
   fprintf(stdout, "-r RED   Reduce Groebner basis.\n");
   fprintf(stdout, "         Default: 1 (yes).\n");
@@ -118,9 +141,22 @@ static inline void display_help(char *str){
   fprintf(stdout, "         compute the saturation of the ideal\n");
   fprintf(stdout, "         generated by the first k-1 polynomials\n");
   fprintf(stdout, "         with respect to the kth polynomial.\n");
+  fprintf(stdout, "-T FILE  Tracer file for multi-modular computations over\n");
+  fprintf(stdout, "         the rationals. If FILE holds a tracer learned for\n");
+  fprintf(stdout, "         input data with the same support, the learning\n");
+  fprintf(stdout, "         phase is skipped. Otherwise the newly learned\n");
+  fprintf(stdout, "         tracer is written to FILE.\n");
   fprintf(stdout, "-u UHT   Number of steps after which the\n");
   fprintf(stdout, "         hash table is newly generated.\n");
-  fprintf(stdout, "         Default: 0, i.e. no update.\n");
+  fprintf(stdout, "         Default: 0, i.e. the basis hash table is\n");
+  fprintf(stdout, "         compacted automatically when most of its\n");
+  fprintf(stdout, "         monomials are no longer used.\n");
+  fprintf(stdout, "-x FAC   Splits the eliminating polynomial before real\n");
+  fprintf(stdout, "         root isolation, its factors are isolated in parallel.\n");
+  fprintf(stdout, "         0 - no splitting (default).\n");
+  fprintf(stdout, "         1 - square-free decomposition.\n");
+  fprintf(stdout, "         2 - square-free decomposition, then factorization\n");
+  fprintf(stdout, "             of the square-free factors of small degree.\n");
 }
 
 static void getoptions(
@@ -143,6 +179,8 @@ static void getoptions(
         int32_t *is_gb,
         int32_t *get_param,
         int32_t *precision,
+        int32_t *factor_elim,
+        int32_t *prime_bits,
         int32_t *refine,
         int32_t *isolate,
         int32_t *generate_pbm_files,
@@ -153,8 +191,10 @@ static void getoptions(
   char *bin_filename = NULL;
   char *out_fname = NULL;
   char *bin_out_fname = NULL;
+  char *trace_fname = NULL;
+  char *batch_fname = NULL;
   opterr = 1;
-  char options[] = "hf:F:v:l:t:e:o:O:u:i:I:p:P:q:g:c:s:SCr:R:m:M:n:";
+  char options[] = "hf:F:v:l:t:e:o:O:u:i:I:p:P:q:g:c:s:SCr:R:m:M:n:x:B:T:b:";
   while((opt = getopt(argc, argv, options)) != -1) {
     switch(opt) {
     case 'h':
@@ -178,6 +218,21 @@ static void getoptions(
       /*     *precision = 100; */
       /* } */
       break;
+    case 'x':
+      *factor_elim = strtol(optarg, NULL, 10);
+      if (*factor_elim < 0) {
+          *factor_elim = 0;
+      }
+      if (*factor_elim > 2) {
+          *factor_elim = 2;
+      }
+      break;
+    case 'B':
+      *prime_bits = strtol(optarg, NULL, 10);
+      if (*prime_bits != 62) {
+          *prime_bits = 31;
+      }
+      break;
     case 'q':
       *use_signatures = strtol(optarg, NULL, 10);
       if (*use_signatures < 0) {
@@ -240,6 +295,13 @@ static void getoptions(
     case 'O':
       bin_out_fname = optarg;
       break;
+    case 'T':
+      trace_fname = optarg;
+      break;
+    case 'b':
+      fflag = 0;
+      batch_fname = optarg;
+      break;
     case 'P':
       *get_param = strtol(optarg, NULL, 10);
       if (*get_param <= 0) {
@@ -298,57 +360,67 @@ static void getoptions(
   files->bin_file = bin_filename;
   files->out_file = out_fname;
   files->bin_out_file = bin_out_fname;
+  files->trace_file = trace_fname;
+  files->batch_file = batch_fname;
 }
 
 
-int main(int argc, char **argv){
-
-    /* timinigs */
-    double st0 = cputime();
-    double rt0 = realtime();
-
-    /**
-      We get values from the command line.
-     **/
-    int32_t la_option             = 2; // by default
-    int32_t use_signatures        = 0;
-    int32_t nr_threads            = 1;
-    int32_t info_level            = 0;
-    int32_t initial_hts           = 17;
-    int32_t max_pairs             = 0;
-    int32_t elim_block_len        = 0;
-    int32_t update_ht             = 0;
-    int32_t generate_pbm          = 0;
-    int32_t reduce_gb             = 1;
-    int32_t print_gb              = 0;
-    int32_t genericity_handling   = 2;
-    int32_t saturate              = 0;
-    int32_t colon                 = 0;
-    int32_t normal_form           = 0;
-    int32_t normal_form_matrix    = 0;
-    int32_t is_gb                 = 0;
-    int32_t get_param             = 0;
-    int32_t precision             = 128;
-    int32_t refine                = 0; /* not used at the moment */
-    int32_t isolate               = 0; /* not used at the moment */
+/* sets the input and output file of the next instance to be solved,
+ * without batch file there is exactly one instance given by the
+ * command line options */
+static int next_batch_instance(
+        FILE *blist,
+        files_gb *files,
+        char *in_fname,
+        char *out_fname,
+        int32_t *nr_instances){
+  if(blist == NULL){
+    return (*nr_instances)++ == 0;
+  }
+  if(fscanf(blist, "%4095s %4095s", in_fname, out_fname) != 2){
+    return 0;
+  }
+  files->in_file = in_fname;
+  files->bin_file = NULL;
+  files->out_file = out_fname;
+  (*nr_instances)++;
+  return 1;
+}
 
-    files_gb *files = malloc(sizeof(files_gb));
-    files->in_file = NULL;
-    files->bin_file = NULL;
-    files->out_file = NULL;
-    files->bin_out_file = NULL;
-    getoptions(argc, argv, &initial_hts, &nr_threads, &max_pairs,
-               &elim_block_len, &la_option, &use_signatures, &update_ht,
-               &reduce_gb, &print_gb, &genericity_handling, &saturate, &colon,
-               &normal_form, &normal_form_matrix, &is_gb, &get_param,
-               &precision, &refine, &isolate, &generate_pbm, &info_level, files);
+/* solves the instance given by files, returns 0 on success. options are
+ * passed by value so that adjustments for one instance (e.g. of la_option)
+ * do not carry over to the next instance of a batch. */
+static int solve_instance(
+        files_gb *files,
+        int32_t la_option,
+        const int32_t use_signatures,
+        const int32_t nr_threads,
+        const int32_t info_level,
+        const int32_t initial_hts,
+        const int32_t max_pairs,
+        const int32_t elim_block_len,
+        const int32_t update_ht,
+        const int32_t generate_pbm,
+        const int32_t reduce_gb,
+        const int32_t print_gb,
+        const int32_t get_param,
+        const int32_t genericity_handling,
+        const int32_t saturate,
+        const int32_t colon,
+        const int32_t normal_form,
+        const int32_t normal_form_matrix,
+        const int32_t is_gb,
+        const int32_t precision,
+        const int32_t factor_elim,
+        const int32_t prime_bits,
+        const int32_t isolate){
 
     FILE *fh  = fopen(files->in_file, "r");
     FILE *bfh  = fopen(files->bin_file, "r");
 
     if (fh == NULL && bfh == NULL) {
       fprintf(stderr, "Input file not found.\n");
-      exit(1);
+      return 1;
     }
     if(fh!=NULL){
       fclose(fh);
@@ -364,7 +436,7 @@ int main(int argc, char **argv){
       FILE *ofile = fopen(files->out_file, "w");
       if(ofile == NULL){
         fprintf(stderr, "Cannot open output file\n");
-        exit(1);
+        return 1;
       }
       fclose(ofile);
     }
@@ -393,7 +465,7 @@ int main(int argc, char **argv){
       real_point_t **lreal_pts = NULL;
       isolate_real_roots_lparam(lparams, &lnbr,
                                 &lreal_roots, &lreal_pts,
-                                precision, nr_threads, info_level);
+                                precision, factor_elim, nr_threads, info_level);
       if(info_level){
         fprintf(stderr, "Total elapsed time = %.2f\n", realtime() - st);
       }
@@ -412,11 +484,11 @@ int main(int argc, char **argv){
       free(lnbr);
       free(lreal_roots);
       free(lreal_pts);
-      free(files);
       return 0;
     }
 
-    get_data_from_file(files->in_file, &nr_vars, &field_char, &nr_gens, gens);
+    get_data_from_file(files->in_file, &nr_vars, &field_char, &nr_gens, gens,
+                       nr_threads);
 #ifdef IODEBUG
     display_gens(stdout, gens);
 #endif
@@ -445,8 +517,8 @@ int main(int argc, char **argv){
                           initial_hts, max_pairs, elim_block_len, update_ht,
                           generate_pbm, reduce_gb, print_gb, get_param,
                           genericity_handling, saturate, colon, normal_form,
-                          normal_form_matrix, is_gb, precision, 
-                          files, gens,
+                          normal_form_matrix, is_gb, precision, factor_elim,
+                          prime_bits, files, gens,
             &param, &mpz_param, &nb_real_roots, &real_roots, &real_pts);
 
     /* free parametrization */
@@ -463,6 +535,142 @@ int main(int argc, char **argv){
     }
     free(real_roots);
 
+    free_data_gens(gens);
+    /* for(long i = 0; i < gens->nvars; i++){
+        free(gens->vnames[i]);
+    }
+    free(gens->vnames);
+    free(gens->lens);
+    free(gens->cfs);
+    free(gens->exps);
+    free(gens->random_linear_form); */
+    return ret;
+}
+
+int main(int argc, char **argv){
+
+    /* timinigs */
+    double st0 = cputime();
+    double rt0 = realtime();
+
+    /**
+      We get values from the command line.
+     **/
+    int32_t la_option             = 2; // by default
+    int32_t use_signatures        = 0;
+    int32_t nr_threads            = 1;
+    int32_t info_level            = 0;
+    int32_t initial_hts           = 17;
+    int32_t max_pairs             = 0;
+    int32_t elim_block_len        = 0;
+    int32_t update_ht             = 0;
+    int32_t generate_pbm          = 0;
+    int32_t reduce_gb             = 1;
+    int32_t print_gb              = 0;
+    int32_t genericity_handling   = 2;
+    int32_t saturate              = 0;
+    int32_t colon                 = 0;
+    int32_t normal_form           = 0;
+    int32_t normal_form_matrix    = 0;
+    int32_t is_gb                 = 0;
+    int32_t get_param             = 0;
+    int32_t precision             = 128;
+    int32_t factor_elim           = 0;
+    int32_t prime_bits            = 31;
+    int32_t refine                = 0; /* not used at the moment */
+    int32_t isolate               = 0; /* not used at the moment */
+
+    files_gb *files = malloc(sizeof(files_gb));
+    files->in_file = NULL;
+    files->bin_file = NULL;
+    files->out_file = NULL;
+    files->bin_out_file = NULL;
+    files->trace_file = NULL;
+    files->batch_file = NULL;
+    files->trace_cache = NULL;
+    files->staircase_cache = NULL;
+    getoptions(argc, argv, &initial_hts, &nr_threads, &max_pairs,
+               &elim_block_len, &la_option, &use_signatures, &update_ht,
+               &reduce_gb, &print_gb, &genericity_handling, &saturate, &colon,
+               &normal_form, &normal_form_matrix, &is_gb, &get_param,
+               &precision, &factor_elim, &prime_bits, &refine, &isolate,
+               &generate_pbm, &info_level, files);
+
+    if(isolate == 2){
+      int bin = (files->in_file == NULL);
+      char *fn = bin ? files->bin_file : files->in_file;
+      if(fn == NULL){
+        fprintf(stderr, "Option -I 2 needs an input file given by -f or -F");
+        fprintf(stderr, " (- for the standard input).\n");
+        free(files);
+        return 1;
+      }
+      FILE *infile = stdin;
+      if(strcmp(fn, "-")){
+        infile = fopen(fn, bin ? "rb" : "r");
+        if(infile == NULL){
+          fprintf(stderr, "Input file not found.\n");
+          exit(1);
+        }
+      }
+      FILE *outfile = stdout;
+      if(files->out_file != NULL){
+        outfile = fopen(files->out_file, "w");
+        if(outfile == NULL){
+          fprintf(stderr, "Cannot open output file\n");
+          exit(1);
+        }
+      }
+      isolate_real_roots_stream(infile, outfile, bin, precision, factor_elim,
+                                nr_threads, info_level);
+      if(infile != stdin){
+        fclose(infile);
+      }
+      if(outfile != stdout){
+        fclose(outfile);
+      }
+      free(files);
+      return 0;
+    }
+
+    /* batch mode: each line of the batch file holds the names of an input
+     * and an output file, instances with the same support share the tracer */
+    FILE *blist = NULL;
+    char bin_fname[4096], bout_fname[4096];
+    int32_t nr_instances = 0;
+    if (files->batch_file != NULL) {
+      blist = fopen(files->batch_file, "r");
+      if (blist == NULL) {
+        fprintf(stderr, "Batch file not found.\n");
+        exit(1);
+      }
+      files->trace_cache = calloc(1, sizeof(tc_t));
+      files->staircase_cache = calloc(1, sizeof(sc_t));
+    }
+    int ret = 0;
+    while (next_batch_instance(blist, files, bin_fname, bout_fname,
+                               &nr_instances)) {
+        int r = solve_instance(files, la_option, use_signatures, nr_threads,
+                               info_level, initial_hts, max_pairs,
+                               elim_block_len, update_ht, generate_pbm,
+                               reduce_gb, print_gb, get_param,
+                               genericity_handling, saturate, colon,
+                               normal_form, normal_form_matrix, is_gb,
+                               precision, factor_elim, prime_bits, isolate);
+        if (r != 0) {
+            /* a bad instance does not stop the batch */
+            if (blist != NULL) {
+                fprintf(stderr, "Instance %s failed.\n", files->in_file);
+            }
+            ret = r;
+        }
+    }
+    if (blist != NULL) {
+      fclose(blist);
+      free_trace_cache(&(files->trace_cache));
+      free_staircase_cache(&(files->staircase_cache));
+    }
+
     /* timings */
     if (info_level > 0) {
         double st1 = cputime();
@@ -474,15 +682,6 @@ int main(int argc, char **argv){
         fprintf(stderr, "-------------------------------------------------\
 -----------------------------------\n");
     }
-    free_data_gens(gens);
-    /* for(long i = 0; i < gens->nvars; i++){
-        free(gens->vnames[i]);
-    }
-    free(gens->vnames);
-    free(gens->lens);
-    free(gens->cfs);
-    free(gens->exps);
-    free(gens->random_linear_form); */
     free(files);
     return ret;
 }
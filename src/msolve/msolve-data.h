@@ -166,11 +166,17 @@ typedef struct{
 } real_point_struct;
 typedef real_point_struct real_point_t[1];
 
+typedef struct sc_t sc_t; /* see hilbert.c */
+
 typedef struct{
   char *in_file;
   char *bin_file;
   char *out_file;
   char *bin_out_file;
+  char *trace_file;
+  char *batch_file;
+  tc_t *trace_cache; /* tracer shared by the instances of a batch */
+  sc_t *staircase_cache; /* staircase shared by the instances of a batch */
 } files_gb;
 
 /* data structure for tracing algorithms */
@@ -211,6 +217,8 @@ typedef struct{
   int32_t info_level;
   int32_t print_gb;
   int32_t pbm_file;
+  int32_t prime_bits; /* bit size of the primes used for multi-modular
+                         computations (31 or 62) */
   files_gb *files;
 } msolveflags_struct;
 typedef msolveflags_struct msflags_t[1];
@@ -18,6 +18,8 @@
  * Christian Eder
  * Mohab Safey El Din */
 
+#include <flint/fmpz_poly.h>
+#include <flint/fmpz_poly_factor.h>
 #include "msolve.h"
 #include "duplicate.c"
 #include "linear.c"
@@ -33,6 +35,9 @@
 #endif
 #define LOG2(X) ((unsigned) (8*sizeof (unsigned long long) - __builtin_clzll((X)) - 1))
 #define ilog2_mpz(a) mpz_sizeinbase(a,2)
+/* square-free factors of larger degree are not handed to the full
+ * factorization of FLINT before real root isolation */
+#define FACTOR_ELIM_MAX_DEG 512
 
 static void mpz_upoly_init(mpz_upoly_t poly, long alloc){
   mpz_t *tmp = NULL;
@@ -1006,17 +1011,23 @@ static inline void crt_lift_mpz_upoly(mpz_upoly_t pol, nmod_poly_t nmod_pol,
 
 
 /* assumes that all degrees are the same */
+/* polynomials which are frozen (see freeze_param_modular) are not lifted */
 static inline void crt_lift_mpz_param(mpz_param_t mpz_param, param_t *nmod_param,
                                       mpz_t modulus, mpz_t prod_crt,
-                                      const int32_t prime, mpz_t tmp, const int nthrds){
+                                      const int32_t prime, mpz_t tmp,
+                                      const int *is_frozen, const int nthrds){
 
   /*assumes prod_crt = modulus * prime */
-  crt_lift_mpz_upoly(mpz_param->elim, nmod_param->elim, modulus, prime,
-                     prod_crt, tmp, nthrds);
+  if(is_frozen[0] == 0){
+    crt_lift_mpz_upoly(mpz_param->elim, nmod_param->elim, modulus, prime,
+                       prod_crt, tmp, nthrds);
+  }
   for(long i = 0; i < mpz_param->nvars - 1; i++){
 
-    crt_lift_mpz_upoly(mpz_param->coords[i], nmod_param->coords[i],
-                       modulus, prime, prod_crt, tmp, nthrds);
+    if(is_frozen[i+1] == 0){
+      crt_lift_mpz_upoly(mpz_param->coords[i], nmod_param->coords[i],
+                         modulus, prime, prod_crt, tmp, nthrds);
+    }
 
   }
 
@@ -1357,6 +1368,7 @@ static inline int new_rational_reconstruction(mpz_param_t mpz_param,
                                               long *maxrec,
                                               long *matrec,
                                               int *is_lifted,
+                                              const int *is_frozen,
                                               int *mat_lifted,
                                               int doit,
                                               int nthrds,
@@ -1364,7 +1376,7 @@ static inline int new_rational_reconstruction(mpz_param_t mpz_param,
 
   mpz_mul_ui(prod_crt, *modulus, prime);
   crt_lift_mpz_param(tmp_mpz_param, nmod_param, *modulus, prod_crt,
-                     prime, trace_det->tmp, nthrds);
+                     prime, trace_det->tmp, is_frozen, nthrds);
 
   uint32_t trace_mod = nmod_param->elim->coeffs[trace_det->trace_idx];
   uint32_t det_mod = nmod_param->elim->coeffs[trace_det->det_idx];
@@ -1704,15 +1716,19 @@ static inline int check_param_modular(const mpz_param_t mp_param,
                                       const param_t *bparam,
                                       const int32_t prime,
                                       int *is_lifted,
+                                      const int *is_frozen,
                                       trace_det_fglm_mat_t trace_det,
                                       const int info_level){
 
   long len = mp_param->nsols + 1;
 
-  int c = check_unit_mpz_nmod_poly(len,
-                                    mp_param->elim,
-                                    bparam->elim,
-                                    prime);
+  int c = 0;
+  if(is_frozen[0] == 0){
+    c = check_unit_mpz_nmod_poly(len,
+                                 mp_param->elim,
+                                 bparam->elim,
+                                 prime);
+  }
   if(c){
     if(info_level){
       fprintf(stderr, "<0,%d>", c);
@@ -1731,7 +1747,7 @@ static inline int check_param_modular(const mpz_param_t mp_param,
   for(int i = 0; i <mp_param->nvars-1; i++ ){
     len = mp_param->coords[0]->length;
 
-    if(check_param_nmod_poly(bparam->coords[i]->length,
+    if(is_frozen[i+1] == 0 && check_param_nmod_poly(bparam->coords[i]->length,
                              mp_param->coords[i],
                              mp_param->cfs[i],
                              mp_param->elim->coeffs[mp_param->elim->length - 1],
@@ -1749,6 +1765,59 @@ static inline int check_param_modular(const mpz_param_t mp_param,
 }
 
 
+/**
+   polynomials of mp_param which are reconstructed and match bparam
+   modulo a prime which was not used to reconstruct them are frozen:
+   they are not computed by fglm, lifted nor reconstructed anymore for
+   the next primes. Coordinates are frozen once elim is.
+   A reconstructed coordinate which does not match bparam is marked as
+   not lifted.
+   renvoie 1 si tous les polynomes sont geles.
+**/
+
+static inline int freeze_param_modular(const mpz_param_t mp_param,
+                                       const param_t *bparam,
+                                       const int32_t prime,
+                                       int *is_lifted,
+                                       int *is_frozen,
+                                       const int info_level){
+  if(is_frozen[0] == 0){
+    if(is_lifted[0] == 0 ||
+       check_unit_mpz_nmod_poly(mp_param->nsols + 1,
+                                mp_param->elim,
+                                bparam->elim,
+                                prime)){
+      return 0;
+    }
+    is_frozen[0] = 1;
+  }
+  int nfrozen = 0;
+  for(int i = 0; i < mp_param->nvars - 1; i++){
+    if(is_frozen[i+1] == 0 && is_lifted[i+1]){
+      if(check_param_nmod_poly(bparam->coords[i]->length,
+                               mp_param->coords[i],
+                               mp_param->cfs[i],
+                               mp_param->elim->coeffs[mp_param->elim->length - 1],
+                               mp_param->elim->length - 1,
+                               bparam->coords[i],
+                               prime)){
+        is_lifted[i+1] = 0;
+        if(info_level){
+          fprintf(stderr, "<%d>", i+1);
+        }
+      }
+      else{
+        is_frozen[i+1] = 1;
+        if(info_level){
+          fprintf(stderr, "(%d)", i+1);
+        }
+      }
+    }
+    nfrozen += is_frozen[i+1];
+  }
+  return nfrozen == mp_param->nvars - 1;
+}
+
 static inline void get_leading_ideal_information(
         int32_t *num_gb,
         int32_t **lead_mons,
@@ -1839,6 +1908,7 @@ static int32_t *initial_modular_step(
         long *dquot_ori,
         data_gens_ff_t *gens,
         files_gb *files,
+        int *tracer_from_file,
         int *success)
 {
     double rt = realtime();
@@ -1848,6 +1918,17 @@ static int32_t *initial_modular_step(
     int32_t error              = 0;
     int32_t empty_solution_set = 1;
     bs_t *bs = core_gba(gbg, md, &error, fc);
+    /* a tracer read from file may not fit this input, learn a new one */
+    if (error > 0 && md->trace_level == APPLY_TRACER) {
+        if (md->info_level > 0) {
+            fprintf(stderr, "\nTracer from file does not apply, learning a new one.\n");
+        }
+        free_trace(&(md->tr));
+        *tracer_from_file = 0;
+        md->trace_level = NO_TRACER;
+        error = 0;
+        bs = core_gba(gbg, md, &error, fc);
+    }
 
     print_tracer_statistics(stdout, rt, md);
 
@@ -1866,19 +1947,49 @@ static int32_t *initial_modular_step(
             leadmons[0], bs);
     if (has_dimension_zero(bs->lml, bs->ht->nv, leadmons[0])) {
         long dquot = 0;
-        int32_t *lmb = monomial_basis(bs->lml, bs->ht->nv, leadmons[0], &dquot);
+        int32_t *lmb = NULL;
+        /* batch instances with the same leading ideal share the staircase
+         * and the index structure of the multiplication matrix */
+        if (files->staircase_cache != NULL) {
+            lmb = staircase_from_cache(files->staircase_cache, leadmons[0],
+                    bs->lml, bs->ht->nv, &dquot);
+        }
+        const int cached = lmb != NULL;
+        if (!cached) {
+            lmb = monomial_basis(bs->lml, bs->ht->nv, leadmons[0], &dquot);
+        }
 
         if(md->info_level){
             fprintf(stderr, "Dimension of quotient: %ld\n", dquot);
+            if(cached){
+                fprintf(stderr, "Staircase of previous batch instance reused\n");
+            }
         }
         if(print_gb==0){
-            *bmatrix = build_matrixn_from_bs_trace(bdiv_xn,
-                    blen_gb_xn,
-                    bstart_cf_gb_xn,
-                    lmb, dquot, bs, bs->ht,
-                    leadmons[0], bs->ht->nv,
-                    fc,
-                    md->info_level);
+            if(cached){
+                *bmatrix = build_matrixn_from_bs_cached(bdiv_xn,
+                        blen_gb_xn,
+                        bstart_cf_gb_xn,
+                        files->staircase_cache,
+                        bs, bs->ht,
+                        fc,
+                        md->nthrds);
+            }
+            else{
+                *bmatrix = build_matrixn_from_bs_trace(bdiv_xn,
+                        blen_gb_xn,
+                        bstart_cf_gb_xn,
+                        lmb, dquot, bs, bs->ht,
+                        leadmons[0], bs->ht->nv,
+                        fc,
+                        md->info_level,
+                        md->nthrds);
+                if(*bmatrix != NULL && files->staircase_cache != NULL){
+                    cache_staircase(files->staircase_cache, leadmons[0],
+                            bs->lml, bs->ht->nv, lmb, dquot, *bdiv_xn,
+                            *bmatrix);
+                }
+            }
             if(*bmatrix == NULL){
                 *success = 0;
                 *dim = 0;
@@ -2037,7 +2148,8 @@ static int32_t * modular_trace_learning(sp_matfglm_t **bmatrix,
                                                lmb, dquot, bs, bht,
                                                bexp_lm, bht->nv,
                                                fc,
-                                               info_level);
+                                               info_level,
+                                               st->nthrds);
         if(*bmatrix == NULL){
             *success = 0;
             *dim = 0;
@@ -2146,7 +2258,8 @@ static int32_t * modular_probabilistic_first(sp_matfglm_t **bmatrix,
                                                lmb, dquot, bs, bht,
                                                bexp_lm, bht->nv,
                                                fc,
-                                               info_level);
+                                               info_level,
+                                               st->nthrds);
 
         if(*bmatrix == NULL){
           *success = 0;
@@ -2259,7 +2372,8 @@ for (i = 0; i < st->nprimes; ++i){
                                             start_cf_gb_xn[i],
                                             lmb_ori, dquot_ori, bs[i], bht,
                                             leadmons_ori[i], bht->nv,
-                                            lp->p[i]);
+                                            lp->p[i],
+                                            st->nthrds);
 
     if(nmod_fglm_compute_apply_trace_data(bmatrix[i], lp->p[i],
                                           nmod_params[i],
@@ -2379,7 +2493,8 @@ static void secondary_modular_steps(sp_matfglm_t **bmatrix,
                     start_cf_gb_xn[i],
                     lmb_ori, dquot_ori, bs[i], bs[i]->ht,
                     leadmons_ori[i], bs[i]->ht->nv,
-                    lp->p[i]);
+                    lp->p[i],
+                    st->nthrds);
             if(nmod_fglm_compute_apply_trace_data(bmatrix[i], lp->p[i],
                         nmod_params[i],
                         bs[i]->ht->nv,
@@ -2507,7 +2622,8 @@ static void modular_trace_application(sp_matfglm_t **bmatrix,
                                               start_cf_gb_xn[i],
                                               lmb_ori, dquot_ori, bs[i], bht[i],
                                               leadmons_ori[i], bht[i]->nv,
-                                              lp->p[i]);
+                                              lp->p[i],
+                                              st->nthrds);
       if(nmod_fglm_compute_apply_trace_data(bmatrix[i], lp->p[i],
                                             nmod_params[i],
                                             bht[i]->nv,
@@ -2698,10 +2814,33 @@ int msolve_trace_qq(mpz_param_t mpz_param,
   else{
     lp->old = 0;
     lp->ld = 1;
-    lp->p = calloc(1, sizeof(uint32_t));
+    lp->p = calloc(1, sizeof(uint64_t));
     normalize_initial_basis(bs_qq, st->fc);
   }
 
+  /* a tracer learned for input data with the same support lets us
+   * skip the learning phase. tracer_from_file is set as long as we use
+   * such a tracer, it is then neither written nor cached again. */
+  int tracer_from_file = 0;
+  if (gens->field_char == 0 && st->laopt < 40) {
+    if (files->trace_cache != NULL) {
+      st->tr = trace_from_cache(files->trace_cache, bs_qq, st);
+      if (st->tr != NULL && info_level) {
+        fprintf(stderr, "Tracer of previous batch instance reused\n");
+      }
+    }
+    if (st->tr == NULL && files->trace_file != NULL) {
+      st->tr = read_trace_file(files->trace_file, bs_qq, st);
+      if (st->tr != NULL && info_level) {
+        fprintf(stderr, "Tracer read from %s\n", files->trace_file);
+      }
+    }
+    if (st->tr != NULL) {
+      tracer_from_file = 1;
+      st->trace_level = APPLY_TRACER;
+    }
+  }
+
   /* generate array to store modular bases */
   bs_t **bs = (bs_t **)calloc((unsigned long)st->nthrds, sizeof(bs_t *));
 
@@ -2801,8 +2940,22 @@ int msolve_trace_qq(mpz_param_t mpz_param,
                                             dim_ptr, dquot_ptr,
                                             gens,
                                             files,
+                                            &tracer_from_file,
                                             &success);
 #endif
+  /* store a newly learned tracer for upcoming runs */
+  if (files->trace_file != NULL && st->tr != NULL && !tracer_from_file) {
+    if (write_trace_file(files->trace_file, st->tr, bs_qq, st) != 0) {
+      fprintf(stderr, "Could not write tracer to %s\n", files->trace_file);
+    } else {
+      if (info_level) {
+        fprintf(stderr, "Tracer written to %s\n", files->trace_file);
+      }
+    }
+  }
+  if (files->trace_cache != NULL && st->tr != NULL && !tracer_from_file) {
+    cache_trace(files->trace_cache, st->tr, bs_qq, st);
+  }
   if(*dim_ptr == 0 && success && *dquot_ptr > 0 && print_gb == 0){
     if(nmod_params[0]->elim->length - 1 != *dquot_ptr){
       for(int i = 0; i < nr_vars - 1; i++){
@@ -2989,6 +3142,14 @@ int msolve_trace_qq(mpz_param_t mpz_param,
   for(int i = 0; i < nr_vars; ++i){
     is_lifted[i] = 0;
   }
+  /* is_frozen[0] (resp. is_frozen[i+1]) is set once elim (resp. the i-th
+     coordinate) is reconstructed and verified, it is then skipped */
+  int *is_frozen = calloc(nr_vars, sizeof(int));
+  for(int i = 0; i < st->nthrds; ++i){
+    if(nmod_params[i] != NULL){
+      nmod_params[i]->skip = is_frozen + 1;
+    }
+  }
   int mat_lifted = 0;
   int nbdoit = 1;
   int doit = 1;
@@ -3004,26 +3165,17 @@ int msolve_trace_qq(mpz_param_t mpz_param,
   /* measures time spent in rational reconstruction */
   double strat = 0;
 
+  screened_primes_t sprimes[1];
+  init_screened_primes(sprimes, bs_qq, prime, primeinit);
+
   while(rerun == 1 || mcheck == 1){
 
     /* controls call to rational reconstruction */
     doit = ((prdone%nbdoit) == 0);
 
     /* generate lucky prime numbers */
-    prime = next_prime(prime);
-    lp->p[0] = prime;
-    while(is_lucky_prime_ui(prime, bs_qq) || prime==primeinit){
-      prime = next_prime(prime);
-      lp->p[0] = prime;
-    }
-
-    for(len_t i = 1; i < st->nthrds; i++){
-      prime = next_prime(prime);
-      lp->p[i] = prime;
-      while(is_lucky_prime_ui(prime, bs_qq) || prime==primeinit){
-        prime = next_prime(prime);
-        lp->p[i] = prime;
-      }
+    for(len_t i = 0; i < st->nthrds; i++){
+      lp->p[i] = next_screened_prime(sprimes, st->nthrds);
     }
     prime = lp->p[st->nthrds - 1];
 
@@ -3083,7 +3235,15 @@ int msolve_trace_qq(mpz_param_t mpz_param,
       if(bad_primes[i] == 0){
         if(rerun == 0){
           mcheck = check_param_modular(mpz_param, nmod_params[i], lp->p[i],
-                                       is_lifted, trace_det, info_level);
+                                       is_lifted, is_frozen, trace_det,
+                                       info_level);
+        }
+        else{
+          if(freeze_param_modular(mpz_param, nmod_params[i], lp->p[i],
+                                  is_lifted, is_frozen, info_level)){
+            rerun = 0;
+            mcheck = 0;
+          }
         }
         crr = realtime();
         if(mcheck==1){
@@ -3104,6 +3264,7 @@ int msolve_trace_qq(mpz_param_t mpz_param,
                                            &maxrec,
                                            &matrec,
                                            is_lifted,
+                                           is_frozen,
                                            &mat_lifted,
                                            doit,
                                            st->nthrds, info_level);
@@ -3140,7 +3301,7 @@ int msolve_trace_qq(mpz_param_t mpz_param,
       }
       else{
         if(info_level){
-          fprintf(stderr, "<bp: %d>\n", lp->p[i]);
+          fprintf(stderr, "<bp: %lu>\n", (unsigned long)lp->p[i]);
         }
         nbadprimes++;
         if(nbadprimes > nprimes){
@@ -3153,6 +3314,7 @@ int msolve_trace_qq(mpz_param_t mpz_param,
           mpz_clear(prod_crt);
           trace_det_clear(trace_det);
           free_rrec_data(recdata);
+          free_screened_primes(sprimes);
           fprintf(stderr, "Many other data should be cleaned\n");
           return -4;
         }
@@ -3233,6 +3395,7 @@ int msolve_trace_qq(mpz_param_t mpz_param,
     free(bmatrix[i]->triv_idx);
     free(bmatrix[i]->triv_pos);
     free(bmatrix[i]->dst);
+    free_hybrid_sp_mat_fglm(bmatrix[i]);
     free(bmatrix[i]);
     free(leadmons_ori[i]);
     free(leadmons_current[i]);
@@ -3261,7 +3424,9 @@ int msolve_trace_qq(mpz_param_t mpz_param,
   free(blinvars);
   free(lineqs_ptr);
   free(bsquvars);
+  free_screened_primes(sprimes);
   free(is_lifted);
+  free(is_frozen);
   free(num_gb);
   free(blen_gb_xn);
   free(bstart_cf_gb_xn);
@@ -3666,7 +3831,11 @@ int newvalue_denom(mpz_t *denom, long deg, mpz_t r, long k,
 }
 
 
-void lazy_single_real_root_param(mpz_param_t param, mpz_t *polelim,
+/* upol of degree deg is the polynomial dividing param->elim which isolates
+ * rt, rt is refined against it, polelim is a copy of upol which is used as
+ * workspace */
+void lazy_single_real_root_param(mpz_param_t param, mpz_t *upol, long deg,
+                                 mpz_t *polelim,
                                  interval *rt, long nb, interval *pos_root,
                                  mpz_t *xdo, mpz_t *xup, mpz_t den_up, mpz_t den_do,
                                  mpz_t c, mpz_t tmp, mpz_t val_do, mpz_t val_up,
@@ -3674,6 +3843,7 @@ void lazy_single_real_root_param(mpz_param_t param, mpz_t *polelim,
                                  long prec, long nbits, mpz_t s,
                                  int info_level){
   long ns = param->nsols ;
+  long rd = deg;
   /* root is exact */
   if(rt->isexact==1){
     single_exact_real_root_param(param, rt, nb,
@@ -3706,8 +3876,8 @@ void lazy_single_real_root_param(mpz_param_t param, mpz_t *polelim,
 
     /* root is positive */
     if(mpz_sgn(rt->numer)>=0){
-      get_values_at_bounds(param->elim->coeffs, ns, rt, tab);
-      refine_QIR_positive_root(polelim, &ns, rt, tab, 2* (rt->k),
+      get_values_at_bounds(upol, rd, rt, tab);
+      refine_QIR_positive_root(polelim, &rd, rt, tab, 2* (rt->k),
                                info_level);
     }
     else{
@@ -3717,15 +3887,15 @@ void lazy_single_real_root_param(mpz_param_t param, mpz_t *polelim,
       pos_root->k = rt->k;
       pos_root->sign_left = - (rt->sign_left);
       pos_root->isexact = rt->isexact;
-      for(long i = 0; i<=ns; i++){
+      for(long i = 0; i<=rd; i++){
         if((i & 1) == 1){
           mpz_neg(polelim[i], polelim[i]);
         }
       }
-      get_values_at_bounds(polelim, ns, pos_root, tab);
-      refine_QIR_positive_root(polelim, &ns, pos_root, tab, 2* (pos_root->k) + ns,
+      get_values_at_bounds(polelim, rd, pos_root, tab);
+      refine_QIR_positive_root(polelim, &rd, pos_root, tab, 2* (pos_root->k) + ns,
                                info_level);
-      for(long i = 0; i<=ns; i++){
+      for(long i = 0; i<=rd; i++){
         if((i & 1) == 1){
           mpz_neg(polelim[i], polelim[i]);
         }
@@ -3746,11 +3916,12 @@ void lazy_single_real_root_param(mpz_param_t param, mpz_t *polelim,
       }
     }
 
-    if(ns != param->nsols){
-      for(long i = 0; i < param->elim->length; i++){
-        mpz_set(polelim[i], param->elim->coeffs[i]);
+    /* exact roots found during the refinement are divided out */
+    if(rd != deg){
+      for(long i = 0; i <= deg; i++){
+        mpz_set(polelim[i], upol[i]);
       }
-      ns = param->nsols;
+      rd = deg;
     }
 
     corr *= 2;  /* *((rt->k) + prec); */
@@ -3866,7 +4037,11 @@ void lazy_single_real_root_param(mpz_param_t param, mpz_t *polelim,
 }
 
 
+/* when factors is not NULL, roots[i] was isolated by the factor
+ * factors[rfac[i]] of degree degs[rfac[i]] of param->elim and is refined
+ * against it, else roots are refined against param->elim */
 void extract_real_roots_param(mpz_param_t param, interval *roots, long nb,
+                              mpz_t **factors, long *degs, long *rfac,
                               real_point_t *pts, long prec, long nbits,
                               double step, int info_level){
   long nsols = param->elim->length - 1;
@@ -3897,10 +4072,19 @@ void extract_real_roots_param(mpz_param_t param, interval *roots, long nb,
 
   double et = realtime();
 
+  mpz_t *upol = param->elim->coeffs;
+  long deg = param->elim->length - 1;
   for(long nc = 0; nc < nb; nc++){
     interval *rt = roots+nc;
 
-    lazy_single_real_root_param(param, polelim, rt, nb, pos_root,
+    if(factors != NULL && factors[rfac[nc]] != upol){
+      upol = factors[rfac[nc]];
+      deg = degs[rfac[nc]];
+      for(long i = 0; i <= deg; i++){
+        mpz_set(polelim[i], upol[i]);
+      }
+    }
+    lazy_single_real_root_param(param, upol, deg, polelim, rt, nb, pos_root,
                                 xdo, xup, den_up, den_do,
                                 c, tmp, val_do, val_up, tab,
                                 pts[nc], prec, nbits, s,
@@ -3940,13 +4124,334 @@ void extract_real_roots_param(mpz_param_t param, interval *roots, long nb,
 }
 
 
+/* splits the eliminating polynomial before real root isolation.
+ * factor_elim = 1: square-free decomposition only
+ * factor_elim = 2: square-free factors of degree at most FACTOR_ELIM_MAX_DEG
+ *                  are further factored over the integers
+ * returns the number of factors ; factors are primitive, pairwise coprime and
+ * sorted by decreasing degree, mults stores their multiplicities in elim */
+static long split_elim_polynomial(mpz_upoly_t elim, const int32_t factor_elim,
+                                  mpz_t ***factors_ptr, long **degs_ptr,
+                                  long **mults_ptr, const int32_t info_level){
+  fmpz_poly_t f;
+  fmpz_poly_init2(f, elim->length);
+  for(long i = 0; i < elim->length; i++){
+    fmpz_poly_set_coeff_mpz(f, i, elim->coeffs[i]);
+  }
+  fmpz_poly_factor_t sqf, fac;
+  fmpz_poly_factor_init(sqf);
+  fmpz_poly_factor_init(fac);
+  fmpz_poly_factor_squarefree(sqf, f);
+
+  for(long i = 0; i < sqf->num; i++){
+    long d = fmpz_poly_degree(sqf->p + i);
+    if(factor_elim > 1 && d > 1 && d <= FACTOR_ELIM_MAX_DEG){
+      fmpz_poly_factor_t loc;
+      fmpz_poly_factor_init(loc);
+      fmpz_poly_factor(loc, sqf->p + i);
+      for(long j = 0; j < loc->num; j++){
+        fmpz_poly_factor_insert(fac, loc->p + j, sqf->exp[i] * loc->exp[j]);
+      }
+      fmpz_poly_factor_clear(loc);
+    }
+    else{
+      fmpz_poly_factor_insert(fac, sqf->p + i, sqf->exp[i]);
+    }
+  }
+
+  long nf = fac->num;
+  long *perm = malloc(sizeof(long) * nf);
+  for(long i = 0; i < nf; i++){
+    perm[i] = i;
+  }
+  /* few factors are expected, insertion sort by decreasing degree */
+  for(long i = 1; i < nf; i++){
+    long t = perm[i];
+    long j = i;
+    while(j > 0 && fmpz_poly_degree(fac->p + perm[j - 1])
+          < fmpz_poly_degree(fac->p + t)){
+      perm[j] = perm[j - 1];
+      j--;
+    }
+    perm[j] = t;
+  }
+
+  mpz_t **factors = malloc(sizeof(mpz_t *) * nf);
+  long *degs = malloc(sizeof(long) * nf);
+  long *mults = malloc(sizeof(long) * nf);
+  for(long i = 0; i < nf; i++){
+    fmpz_poly_struct *g = fac->p + perm[i];
+    degs[i] = fmpz_poly_degree(g);
+    mults[i] = fac->exp[perm[i]];
+    factors[i] = malloc(sizeof(mpz_t) * (degs[i] + 1));
+    for(long j = 0; j <= degs[i]; j++){
+      mpz_init(factors[i][j]);
+      fmpz_poly_get_coeff_mpz(factors[i][j], g, j);
+    }
+  }
+  if(info_level){
+    fprintf(stderr, "Eliminating polynomial splits into %ld factor(s) [", nf);
+    for(long i = 0; i < nf; i++){
+      fprintf(stderr, " %ld^%ld", degs[i], mults[i]);
+    }
+    fprintf(stderr, " ]\n");
+  }
+  free(perm);
+  fmpz_poly_factor_clear(fac);
+  fmpz_poly_factor_clear(sqf);
+  fmpz_poly_clear(f);
+
+  *factors_ptr = factors;
+  *degs_ptr = degs;
+  *mults_ptr = mults;
+  return nf;
+}
+
+/* real root of a factor of the eliminating polynomial */
+typedef struct{
+  interval rt;
+  long fac; /* index of the factor */
+  int sgn; /* sign of the factor at the left end of rt */
+} factor_root_t;
+
+/* compares the left ends of the intervals (exact roots are points) */
+static int cmp_factor_root_left(const void *a, const void *b){
+  const interval *ia = &((const factor_root_t *)a)->rt;
+  const interval *ib = &((const factor_root_t *)b)->rt;
+  long ka = MAX(ia->k, 0);
+  long kb = MAX(ib->k, 0);
+  mpz_t va, vb;
+  mpz_init(va);
+  mpz_init(vb);
+  mpz_mul_2exp(va, ia->numer, kb);
+  mpz_mul_2exp(vb, ib->numer, ka);
+  int c = mpz_cmp(va, vb);
+  mpz_clear(va);
+  mpz_clear(vb);
+  return c;
+}
+
+/* returns 1 if the closures of the (sorted) intervals rt1 and rt2 meet,
+ * two open intervals sharing an end point are considered as separated */
+static int intervals_meet(interval *rt1, interval *rt2, mpz_t *tab){
+  long k1 = MAX(rt1->k, 0);
+  long k2 = MAX(rt2->k, 0);
+  /* right end of rt1 is tab[0] / 2^k1 */
+  if(rt1->isexact == 1){
+    mpz_set(tab[0], rt1->numer);
+  }
+  else if(rt1->k >= 0){
+    mpz_add_ui(tab[0], rt1->numer, 1);
+  }
+  else{
+    mpz_set_ui(tab[0], 1);
+    mpz_mul_2exp(tab[0], tab[0], -rt1->k);
+    mpz_add(tab[0], tab[0], rt1->numer);
+  }
+  mpz_mul_2exp(tab[0], tab[0], k2);
+  mpz_mul_2exp(tab[1], rt2->numer, k1);
+  int c = mpz_cmp(tab[1], tab[0]);
+  if(c < 0){
+    return 1;
+  }
+  if(c == 0 && (rt1->isexact == 1 || rt2->isexact == 1)){
+    return 1;
+  }
+  return 0;
+}
+
+/* halves the isolating interval rt of a root of the square-free polynomial
+ * upol ; sgn is the sign of upol at the left end of rt (it is unchanged) */
+static void bisect_isolating_interval(mpz_t *upol, long deg, interval *rt,
+                                      int sgn, mpz_t *tab){
+  long newk = rt->k + 1;
+  if(rt->k >= 0){
+    mpz_mul_2exp(tab[0], rt->numer, 1);
+    mpz_add_ui(tab[0], tab[0], 1);
+    mpz_poly_eval_2exp_naive(upol, deg, tab, newk, tab + 1, tab + 2);
+  }
+  else{
+    mpz_set_ui(tab[0], 1);
+    mpz_mul_2exp(tab[0], tab[0], -newk);
+    mpz_add(tab[0], tab[0], rt->numer);
+    mpz_poly_eval_2exp_naive(upol, deg, tab, 0, tab + 1, tab + 2);
+  }
+  int s = mpz_sgn(tab[1]);
+  if(s == 0){
+    mpz_set(rt->numer, tab[0]);
+    rt->k = MAX(newk, 0);
+    rt->isexact = 1;
+    return;
+  }
+  if(s * sgn < 0){
+    if(rt->k >= 0){
+      mpz_mul_2exp(rt->numer, rt->numer, 1);
+    }
+  }
+  else{
+    mpz_set(rt->numer, tab[0]);
+  }
+  rt->k = newk;
+}
+
+static void free_elim_factors(mpz_t **factors, long *degs, long nf){
+  for(long i = 0; i < nf; i++){
+    for(long j = 0; j <= degs[i]; j++){
+      mpz_clear(factors[i][j]);
+    }
+    free(factors[i]);
+  }
+  free(factors);
+  free(degs);
+}
+
+/* isolates the real roots of elim through those of its factors (see
+ * split_elim_polynomial) ; factors are isolated in parallel and their
+ * isolating intervals are refined until they are pairwise separated.
+ * when factors_ptr is not NULL, the factors, their degrees and their number
+ * are returned together with the index in rfac of the factor isolating each
+ * root: elim may have multiple roots, these roots have to be refined against
+ * their factor. *factors_ptr is set to NULL when elim is square-free. */
+static interval *real_roots_by_factors(mpz_upoly_t elim, const int32_t factor_elim,
+                                       unsigned long int *nbpos_ptr,
+                                       unsigned long int *nbneg_ptr,
+                                       mpz_t ***factors_ptr, long **degs_ptr,
+                                       long *nf_ptr, long **rfac_ptr,
+                                       long prec, int32_t nr_threads,
+                                       int32_t info_level){
+  mpz_t **factors = NULL;
+  long *degs = NULL, *mults = NULL;
+  long nf = split_elim_polynomial(elim, factor_elim, &factors,
+                                  &degs, &mults, info_level);
+
+  if(factors_ptr != NULL){
+    *factors_ptr = NULL;
+    *degs_ptr = NULL;
+    *nf_ptr = 0;
+    *rfac_ptr = NULL;
+  }
+  if(nf == 1 && mults[0] == 1){
+    free_elim_factors(factors, degs, nf);
+    free(mults);
+    mpz_t *pol = calloc(elim->length, sizeof(mpz_t));
+    for(long i = 0; i < elim->length; i++){
+      mpz_init_set(pol[i], elim->coeffs[i]);
+    }
+    interval *roots = real_roots(pol, elim->length - 1, nbpos_ptr, nbneg_ptr,
+                                 prec, nr_threads, info_level);
+    for(long i = 0; i < elim->length; i++){
+      mpz_clear(pol[i]);
+    }
+    free(pol);
+    return roots;
+  }
+
+  interval **froots = malloc(sizeof(interval *) * nf);
+  long *fnb = malloc(sizeof(long) * nf);
+  long i;
+#pragma omp parallel for num_threads(nr_threads)  \
+    private(i) schedule(dynamic, 1)
+  for(i = 0; i < nf; i++){
+    /* real_roots modifies its input */
+    mpz_t *pol = malloc(sizeof(mpz_t) * (degs[i] + 1));
+    for(long j = 0; j <= degs[i]; j++){
+      mpz_init_set(pol[j], factors[i][j]);
+    }
+    unsigned long int np = 0, nn = 0;
+    froots[i] = real_roots(pol, degs[i], &np, &nn, prec, 1, 0);
+    fnb[i] = np + nn;
+    for(long j = 0; j <= degs[i]; j++){
+      mpz_clear(pol[j]);
+    }
+    free(pol);
+  }
+
+  long nb = 0;
+  for(i = 0; i < nf; i++){
+    nb += fnb[i];
+  }
+  factor_root_t *fr = malloc(sizeof(factor_root_t) * nb);
+  mpz_t *tab = (mpz_t*)(calloc(8,sizeof(mpz_t)));
+  for(int j=0;j<8;j++)mpz_init(tab[j]);
+
+  long l = 0;
+  for(i = 0; i < nf; i++){
+    for(long j = 0; j < fnb[i]; j++){
+      fr[l].rt = froots[i][j];
+      fr[l].fac = i;
+      fr[l].sgn = 0;
+      if(fr[l].rt.isexact != 1){
+        get_values_at_bounds(factors[i], degs[i], &fr[l].rt, tab);
+        fr[l].sgn = mpz_sgn(tab[0]);
+      }
+      l++;
+    }
+    free(froots[i]);
+  }
+
+  /* roots of distinct factors are distinct, hence halving the intervals
+   * which meet eventually separates them */
+  int sep = 0;
+  while(!sep){
+    sep = 1;
+    qsort(fr, nb, sizeof(factor_root_t), cmp_factor_root_left);
+    for(l = 0; l + 1 < nb; l++){
+      while(intervals_meet(&fr[l].rt, &fr[l + 1].rt, tab)){
+        sep = 0;
+        for(long j = l; j <= l + 1; j++){
+          if(fr[j].rt.isexact != 1){
+            bisect_isolating_interval(factors[fr[j].fac], degs[fr[j].fac],
+                                      &fr[j].rt, fr[j].sgn, tab);
+          }
+        }
+      }
+    }
+  }
+
+  /* signs of elim at the left ends of the isolating intervals */
+  interval *roots = malloc(sizeof(interval) * nb);
+  long *rfac = malloc(sizeof(long) * (nb + 1));
+  int s = mpz_sgn(elim->coeffs[elim->length - 1]);
+  if((elim->length - 1) % 2 == 1){
+    s = -s;
+  }
+  unsigned long int nbneg = 0;
+  for(l = 0; l < nb; l++){
+    roots[l] = fr[l].rt;
+    rfac[l] = fr[l].fac;
+    roots[l].sign_left = s;
+    if(mults[fr[l].fac] % 2 == 1){
+      s = -s;
+    }
+    if(mpz_sgn(roots[l].numer) < 0){
+      nbneg++;
+    }
+  }
+  *nbneg_ptr = nbneg;
+  *nbpos_ptr = nb - nbneg;
+
+  for(int j=0;j<8;j++)mpz_clear(tab[j]);
+  free(tab);
+  free(fr);
+  free(froots);
+  free(fnb);
+  free(mults);
+  if(factors_ptr != NULL){
+    *factors_ptr = factors;
+    *degs_ptr = degs;
+    *nf_ptr = nf;
+    *rfac_ptr = rfac;
+    return roots;
+  }
+  free(rfac);
+  free_elim_factors(factors, degs, nf);
+  return roots;
+}
+
 static real_point_t *isolate_real_roots_param(mpz_param_t param, long *nb_real_roots_ptr,
                                               interval **real_roots_ptr, 
-                                              int32_t precision, int32_t nr_threads, int32_t info_level){
-  mpz_t *pol = calloc(param->elim->length, sizeof(mpz_t));
-  for(long i = 0; i < param->elim->length; i++){
-    mpz_init_set(pol[i], param->elim->coeffs[i]);
-  }
+                                              int32_t precision, int32_t factor_elim,
+                                              int32_t nr_threads, int32_t info_level){
   long maxnbits = mpz_poly_max_bsize_coeffs(param->elim->coeffs,
                                             param->elim->length - 1);
 
@@ -3960,8 +4465,27 @@ static real_point_t *isolate_real_roots_param(mpz_param_t param, long *nb_real_r
 
   long unsigned int nbpos = 0;
   long unsigned int nbneg = 0;
-  interval *roots = real_roots(pol, param->elim->length - 1,
-                               &nbpos, &nbneg, prec, nr_threads, info_level );
+  interval *roots = NULL;
+  mpz_t **factors = NULL;
+  long *degs = NULL, *rfac = NULL;
+  long nf = 0;
+  if(factor_elim > 0 && param->elim->length > 2){
+    roots = real_roots_by_factors(param->elim, factor_elim, &nbpos, &nbneg,
+                                  &factors, &degs, &nf, &rfac,
+                                  prec, nr_threads, info_level);
+  }
+  else{
+    mpz_t *pol = calloc(param->elim->length, sizeof(mpz_t));
+    for(long i = 0; i < param->elim->length; i++){
+      mpz_init_set(pol[i], param->elim->coeffs[i]);
+    }
+    roots = real_roots(pol, param->elim->length - 1,
+                       &nbpos, &nbneg, prec, nr_threads, info_level );
+    for(long i = 0; i < param->elim->length; i++){
+      mpz_clear(pol[i]);
+    }
+    free(pol);
+  }
   long nb = nbpos + nbneg;
   double step = (realtime() - st) / (nb) * 10 * LOG2(precision);
 
@@ -3981,26 +4505,27 @@ static real_point_t *isolate_real_roots_param(mpz_param_t param, long *nb_real_r
       real_point_init(pts[i], param->nvars);
     }
 
-    extract_real_roots_param(param, roots, nb, pts, precision, maxnbits,
-                             step, info_level);
+    extract_real_roots_param(param, roots, nb, factors, degs, rfac,
+                             pts, precision, maxnbits, step, info_level);
     if(info_level){
       fprintf(stderr, "Elapsed time (real root extraction) = %.2f\n",
               realtime() - st);
     }
   }
+  if(factors != NULL){
+    free_elim_factors(factors, degs, nf);
+    free(rfac);
+  }
   *real_roots_ptr = roots;
   *nb_real_roots_ptr  = nb;
 
-  for(long i = 0; i < param->elim->length; i++){
-    mpz_clear(pol[i]);
-  }
-  free(pol);
   return pts;
 }
 
 void isolate_real_roots_lparam(mpz_param_array_t lparams, long **lnbr_ptr,
                                interval ***lreal_roots_ptr, real_point_t ***lreal_pts_ptr,
-                               int32_t precision, int32_t nr_threads, int32_t info_level){
+                               int32_t precision, int32_t factor_elim,
+                               int32_t nr_threads, int32_t info_level){
   long *lnbr = malloc(sizeof(long) * lparams->nb);
   interval **lreal_roots = malloc(sizeof(interval *) * lparams->nb);
   real_point_t **lreal_pts = malloc(sizeof(real_point_t *) * lparams->nb);
@@ -4012,7 +4537,8 @@ void isolate_real_roots_lparam(mpz_param_array_t lparams, long **lnbr_ptr,
   for(int i = 0; i < lparams->nb; i++){
     lreal_pts[i] = isolate_real_roots_param(lparams->params[i], lnbr + i,
                                             lreal_roots + i,
-                                            precision, nr_threads, info_level);
+                                            precision, factor_elim,
+                                            nr_threads, info_level);
   }
   (*lnbr_ptr)        = lnbr;
   (*lreal_roots_ptr) = lreal_roots;
@@ -4020,6 +4546,172 @@ void isolate_real_roots_lparam(mpz_param_array_t lparams, long **lnbr_ptr,
 
 }
 
+/* replaces pol by its square-free part, returns 1 if pol was not
+ * square-free, else 0 */
+static int make_square_free_upoly(mpz_upoly_t pol){
+  fmpz_poly_t f, df, g;
+  fmpz_poly_init2(f, pol->length);
+  fmpz_poly_init(df);
+  fmpz_poly_init(g);
+  for(long i = 0; i < pol->length; i++){
+    fmpz_poly_set_coeff_mpz(f, i, pol->coeffs[i]);
+  }
+  fmpz_poly_derivative(df, f);
+  fmpz_poly_gcd(g, f, df);
+  int b = (fmpz_poly_degree(g) > 0);
+  if(b){
+    fmpz_poly_div(f, f, g);
+    pol->length = fmpz_poly_length(f);
+    for(long i = 0; i < pol->length; i++){
+      fmpz_poly_get_coeff_mpz(pol->coeffs[i], f, i);
+    }
+  }
+  fmpz_poly_clear(f);
+  fmpz_poly_clear(df);
+  fmpz_poly_clear(g);
+  return b;
+}
+
+/* number of polynomials per thread read in each round of the stream mode */
+#define STREAM_BATCH_SIZE 64
+
+/* reads at most bsz polynomials from infile into pols, returns the number of
+ * polynomials read */
+static long read_stream_batch(FILE *infile, mpz_upoly_t *pols, const long bsz,
+                              const int bin){
+  long n = 0;
+  while(n < bsz && get_next_poly_from_stream(infile, pols[n], bin)){
+    n++;
+  }
+  return n;
+}
+
+/* isolates the real roots of pol, the idx-th polynomial of the stream */
+static void isolate_stream_poly(mpz_upoly_t pol, interval **roots_ptr,
+                                unsigned long int *nb_ptr, const long idx,
+                                int32_t precision, int32_t factor_elim,
+                                int32_t info_level){
+  unsigned long int nbpos = 0, nbneg = 0;
+  *roots_ptr = NULL;
+  *nb_ptr = 0;
+  if(pol->length < 2){
+    return;
+  }
+  if(factor_elim > 0 && pol->length > 2){
+    *roots_ptr = real_roots_by_factors(pol, factor_elim, &nbpos, &nbneg,
+                                       NULL, NULL, NULL, NULL,
+                                       precision, 1, 0);
+  }
+  else{
+    /* real_roots expects a square-free polynomial, multiple roots are
+     * only reported once */
+    if(make_square_free_upoly(pol) && info_level){
+      fprintf(stderr, "Polynomial %ld is not square-free, ", idx);
+      fprintf(stderr, "its square-free part is used.\n");
+    }
+    /* real_roots modifies its input, pol is not used afterwards */
+    *roots_ptr = real_roots(pol->coeffs, pol->length - 1,
+                            &nbpos, &nbneg, precision, 1, 0);
+  }
+  *nb_ptr = nbpos + nbneg;
+}
+
+/* prints the roots of a batch of n polynomials to outfile and frees them */
+static void print_stream_batch(FILE *outfile, interval **lroots,
+                               unsigned long int *lnb, const long n){
+  for(long i = 0; i < n; i++){
+    display_roots_system(outfile, lroots[i], lnb[i]);
+    for(unsigned long int j = 0; j < lnb[i]; j++){
+      mpz_clear(lroots[i][j].numer);
+    }
+    free(lroots[i]);
+  }
+  fflush(outfile);
+}
+
+/* isolates the real roots of a stream of univariate polynomials, read from
+ * infile (see get_next_poly_from_stream), until the end of the stream.
+ * polynomials are read by batches whose polynomials are isolated in parallel,
+ * one task per polynomial ; the roots of each batch are printed to outfile,
+ * one line per polynomial, in input order.
+ * two buffers are used so that, while a batch is isolated, one task reads the
+ * next batch and another one prints the previous one. with one thread these
+ * tasks run one after the other. */
+void isolate_real_roots_stream(FILE *infile, FILE *outfile, const int bin,
+                               int32_t precision, int32_t factor_elim,
+                               int32_t nr_threads, int32_t info_level){
+  const long bsz = STREAM_BATCH_SIZE * MAX(nr_threads, 1);
+  mpz_upoly_t *pols = malloc(sizeof(mpz_upoly_t) * 2 * bsz);
+  interval **lroots = malloc(sizeof(interval *) * 2 * bsz);
+  unsigned long int *lnb = malloc(sizeof(unsigned long int) * 2 * bsz);
+  for(long i = 0; i < 2 * bsz; i++){
+    pols[i]->length = 0;
+    pols[i]->alloc = 0;
+    pols[i]->coeffs = NULL;
+  }
+  long npols = 0;
+  double st = realtime();
+
+  /* batch c * bsz is isolated, batch (1 - c) * bsz is read or printed */
+  int c = 0;
+  /* n polynomials to isolate, np to print */
+  long n = read_stream_batch(infile, pols, bsz, bin);
+  long np = 0;
+  while(n > 0 || np > 0){
+    /* a full batch means the stream may go on */
+    const int more = (n == bsz);
+    long nn = 0;
+    mpz_upoly_t *cpols = pols + c * bsz;
+    interval **croots = lroots + c * bsz;
+    unsigned long int *cnb = lnb + c * bsz;
+    const long o = (1 - c) * bsz;
+#pragma omp parallel num_threads(nr_threads)
+    {
+#pragma omp single nowait
+      {
+        if(more){
+#pragma omp task
+          {
+            nn = read_stream_batch(infile, pols + o, bsz, bin);
+          }
+        }
+        if(np){
+#pragma omp task
+          {
+            print_stream_batch(outfile, lroots + o, lnb + o, np);
+          }
+        }
+        for(long i = 0; i < n; i++){
+#pragma omp task
+          {
+            isolate_stream_poly(cpols[i], croots + i, cnb + i, npols + i,
+                                precision, factor_elim, info_level);
+          }
+        }
+#pragma omp taskwait
+      }
+    }
+    npols += n;
+    if(info_level && n){
+      fprintf(stderr, "%ld polynomials processed (%.2f sec)\n",
+              npols, realtime() - st);
+    }
+    np = n;
+    n = nn;
+    c = 1 - c;
+  }
+
+  for(long i = 0; i < 2 * bsz; i++){
+    for(int32_t j = 0; j < pols[i]->alloc; j++){
+      mpz_clear(pols[i]->coeffs[j]);
+    }
+    free(pols[i]->coeffs);
+  }
+  free(pols);
+  free(lroots);
+  free(lnb);
+}
+
 int real_msolve_qq(mpz_param_t mp_param,
                    param_t **nmod_param,
                    int *dim_ptr,
@@ -4039,6 +4731,7 @@ int real_msolve_qq(mpz_param_t mp_param,
                    int32_t print_gb,
                    int32_t pbm_file,
                    int32_t precision,
+                   int32_t factor_elim,
                    files_gb *files,
                    int round,
                    int32_t get_param){
@@ -4092,7 +4785,7 @@ int real_msolve_qq(mpz_param_t mp_param,
   if(b==0 && *dim_ptr == 0 && *dquot_ptr > 0 && gens->field_char == 0){
 
     pts = isolate_real_roots_param(mp_param, nb_real_roots_ptr, real_roots_ptr,
-                                   precision, nr_threads, info_level);
+                                   precision, factor_elim, nr_threads, info_level);
     int32_t nb = *nb_real_roots_ptr;
     if(nb){
       /* If we added a linear form for genericity reasons remove do not
@@ -4261,6 +4954,8 @@ int core_msolve(
   int32_t normal_form_matrix,
   int32_t is_gb,
   int32_t precision,
+  int32_t factor_elim,
+  int32_t prime_bits,
   files_gb *files,
   data_gens_ff_t *gens,
   param_t **paramp,
@@ -4280,6 +4975,15 @@ int core_msolve(
     /* counter for randomly chosen linear forms */
     int round = -1;
 
+    /* there is no signature based tracer for the multi-modular
+     * computations over the rationals, signature based runs over
+     * prime fields only compute a Groebner basis, see below */
+    if (gens->field_char == 0 && use_signatures > 0) {
+        fprintf(stderr, "Signature based algorithms (-q) are only ");
+        fprintf(stderr, "available over prime fields.\n");
+        return 1;
+    }
+
 restart:
 
     param = NULL;
@@ -4307,13 +5011,14 @@ restart:
 
             int success = 0;
 
+            /* signature based computations use 32 bit coefficients for
+             * all prime fields, so we can directly pass the characteristic */
             success = initialize_gba_input_data(&bs, &bht, &st,
                     gens->lens, gens->exps, (void *)gens->cfs,
-                    1073741827, 0 /* DRL order */, elim_block_len, gens->nvars,
-                    /* gens->field_char, 0 [> DRL order <], gens->nvars, */
-                    gens->ngens, saturate, initial_hts, nr_threads, max_pairs,
-                    update_ht, la_option, use_signatures, 1 /* reduce_gb */, 0,
-                    info_level);
+                    gens->field_char, 0 /* DRL order */, elim_block_len,
+                    gens->nvars, gens->ngens, saturate, initial_hts,
+                    nr_threads, max_pairs, update_ht, la_option,
+                    use_signatures, 1 /* reduce_gb */, 0, info_level);
 
             if (st->homogeneous != 1) {
                 fprintf(stderr,
@@ -4322,11 +5027,6 @@ restart:
             }
 
             st->gfc  = gens->field_char;
-            if(info_level){
-                fprintf(stderr,
-                        "NOTE: Field characteristic is now corrected to %u\n",
-                        st->gfc);
-            }
             if (!success) {
                 printf("Bad input data, stopped computation.\n");
                 exit(1);
@@ -4353,6 +5053,10 @@ restart:
                 fprintf(stderr, "Something went wrong during the computation\n");
                 return -1;
             }
+            if (print_gb) {
+                print_ff_basis_data(files->out_file, "a", bs, bht,
+                        st, gens, print_gb);
+            }
             return 0;
         }
 
@@ -4779,7 +5483,7 @@ restart:
                        initial_hts, nr_threads, max_pairs,
                        elim_block_len, update_ht,
                        la_option, use_signatures, info_level, print_gb,
-                       generate_pbm, precision, files, round, get_param);
+                       generate_pbm, precision, factor_elim, files, round, get_param);
           if(print_gb){
             return 0;
           }
@@ -5452,6 +6156,7 @@ restart:
               flags->info_level = info_level;
               flags->pbm_file = generate_pbm;
               flags->print_gb = print_gb;
+              flags->prime_bits = prime_bits;
               flags->files = files;
 
               print_msolve_gbtrace_qq(gens, flags);
@@ -5469,7 +6174,7 @@ restart:
                     initial_hts, nr_threads, max_pairs,
                     elim_block_len, update_ht,
                     la_option, use_signatures, info_level, print_gb,
-                    generate_pbm, precision, files, round, get_param);
+                    generate_pbm, precision, factor_elim, files, round, get_param);
 
             if(print_gb){
               return 0;
@@ -5775,7 +6480,8 @@ void msolve_julia(
             0 /* generate pbm */, 1 /* reduce_gb */, print_gb, get_param,
             genericity_handling, 0 /* saturate */, 0 /* colon */,
 	    0 /* normal_form */, 0 /* normal_form_matrix */,
-	    0 /* is_gb */, precision, files,
+	    0 /* is_gb */, precision, 0 /* factor_elim */,
+            31 /* prime_bits */, files,
             gens, &param, &mpz_param, &nb_real_roots, &real_roots, &real_pts);
 
     if (ret == -1) {
@@ -104,6 +104,7 @@ int real_msolve_qq(
         int32_t print_gb,
         int32_t pbm_file,
         int32_t precision,
+        int32_t factor_elim,
         files_gb *files,
         int,
         int32_t
@@ -129,6 +130,8 @@ int core_msolve(
         int32_t normal_form_matrix,
         int32_t is_gb,
         int32_t precision,
+        int32_t factor_elim,
+        int32_t prime_bits,
         files_gb *files,
         data_gens_ff_t *gens,
         param_t **paramp,
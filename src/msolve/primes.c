@@ -38,3 +38,143 @@ uint32_t next_prime(uint32_t n){
   while(!is_prime(cand)) cand++;
   return cand;
 }
+
+// primes beyond 32 bits for multi-modular computations, assumes n < 2^63
+uint64_t next_prime_64(uint64_t n){
+  mpz_t cand;
+  mpz_init_set_ui(cand, n);
+  mpz_nextprime(cand, cand);
+  uint64_t p = mpz_get_ui(cand);
+  mpz_clear(cand);
+  return p;
+}
+
+/* Supply of 32 bit primes which do not divide any coefficient of the
+ * input system (see is_lucky_prime_ui). Candidates are screened by
+ * batches of SCREEN_BATCH primes per thread. Two candidates are handled
+ * at once: each coefficient is reduced by one mpn_mod_1 call modulo their
+ * product (which fits into a limb), and then modulo each of them. The
+ * primes are delivered in the same order as the sequential loop with
+ * next_prime and is_lucky_prime_ui. */
+#define SCREEN_BATCH 16
+
+typedef struct{
+  mp_srcptr *limbs; /* limbs of the coefficients */
+  mp_size_t *size;  /* number of limbs of the coefficients */
+  long ncfs;        /* number of coefficients */
+  uint32_t *p;      /* screened primes */
+  long ld;          /* number of primes in p */
+  long pos;         /* position of the next prime to deliver */
+  long alloc;       /* allocated size of p */
+  uint32_t last;    /* last candidate which has been screened */
+  uint32_t avoid;   /* prime which is never delivered */
+} screened_primes_t;
+
+/* the coefficients of bs are not copied, bs must outlive sp */
+static inline void init_screened_primes(screened_primes_t *sp,
+                                        const bs_t * const bs,
+                                        const uint32_t start,
+                                        const uint32_t avoid){
+  long ncfs = 0;
+  for(len_t i = 0; i < bs->ld; i++){
+    ncfs += bs->hm[i][LENGTH];
+  }
+  sp->limbs = malloc((ncfs + 1) * sizeof(mp_srcptr));
+  sp->size = malloc((ncfs + 1) * sizeof(mp_size_t));
+  sp->ncfs = 0;
+  for(len_t i = 0; i < bs->ld; i++){
+    mpz_t *cf = bs->cf_qq[bs->hm[i][COEFFS]];
+    for(len_t j = 0; j < bs->hm[i][LENGTH]; j++){
+      sp->limbs[sp->ncfs] = mpz_limbs_read(cf[j]);
+      sp->size[sp->ncfs] = mpz_size(cf[j]);
+      sp->ncfs++;
+    }
+  }
+  sp->p = NULL;
+  sp->ld = 0;
+  sp->pos = 0;
+  sp->alloc = 0;
+  sp->last = start;
+  sp->avoid = avoid;
+}
+
+static inline void free_screened_primes(screened_primes_t *sp){
+  free(sp->limbs);
+  free(sp->size);
+  free(sp->p);
+  sp->limbs = NULL;
+  sp->size = NULL;
+  sp->p = NULL;
+  sp->ld = sp->pos = sp->alloc = 0;
+}
+
+/* sets bad[0] (resp. bad[1]) to 1 if p0 (resp. p1) divides one of the
+ * coefficients, a zero coefficient is divisible by both */
+static inline void screen_prime_pair(const screened_primes_t *sp,
+                                     const uint32_t p0, const uint32_t p1,
+                                     int *bad){
+  const mp_limb_t q = (mp_limb_t)p0 * (mp_limb_t)p1;
+  bad[0] = bad[1] = 0;
+  for(long i = 0; i < sp->ncfs && !(bad[0] && bad[1]); i++){
+    if(sp->size[i] == 0){
+      bad[0] = bad[1] = 1;
+      break;
+    }
+    const mp_limb_t r = mpn_mod_1(sp->limbs[i], sp->size[i], q);
+    bad[0] |= (r % p0 == 0);
+    bad[1] |= (r % p1 == 0);
+  }
+}
+
+static void refill_screened_primes(screened_primes_t *sp, const int nthrds){
+  long nb = 2 * SCREEN_BATCH * (nthrds > 0 ? nthrds : 1);
+  if(sp->alloc < nb){
+    sp->p = realloc(sp->p, nb * sizeof(uint32_t));
+    sp->alloc = nb;
+  }
+  int *bad = malloc(nb * sizeof(int));
+  uint32_t cand = sp->last;
+  for(long i = 0; i < nb; i++){
+    cand = next_prime(cand);
+    sp->p[i] = cand;
+  }
+  sp->last = cand;
+
+#if GMP_LIMB_BITS >= 64
+#pragma omp parallel for num_threads(nthrds) schedule(dynamic) \
+  if(nthrds > 1)
+  for(long i = 0; i < nb / 2; i++){
+    screen_prime_pair(sp, sp->p[2*i], sp->p[2*i+1], bad + 2*i);
+  }
+#else
+#pragma omp parallel for num_threads(nthrds) schedule(dynamic) \
+  if(nthrds > 1)
+  for(long i = 0; i < nb; i++){
+    bad[i] = 0;
+    for(long j = 0; j < sp->ncfs && !bad[i]; j++){
+      bad[i] = (sp->size[j] == 0) ||
+        (mpn_mod_1(sp->limbs[j], sp->size[j], sp->p[i]) == 0);
+    }
+  }
+#endif
+
+  long ld = 0;
+  for(long i = 0; i < nb; i++){
+    if(bad[i] == 0 && sp->p[i] != sp->avoid){
+      sp->p[ld++] = sp->p[i];
+    }
+  }
+  free(bad);
+  sp->ld = ld;
+  sp->pos = 0;
+}
+
+/* returns the next prime of the supply, screening a new batch of
+ * candidates with nthrds threads when needed */
+static inline uint32_t next_screened_prime(screened_primes_t *sp,
+                                           const int nthrds){
+  while(sp->pos == sp->ld){
+    refill_screened_primes(sp, nthrds);
+  }
+  return sp->p[sp->pos++];
+}
@@ -50,6 +50,14 @@ static void free_basis_elements(
             bs->hm[i] = NULL;
         }
     }
+    if (bs->cf_64) {
+        for (i = 0; i < bs->ld; ++i) {
+            free(bs->cf_64[i]);
+            bs->cf_64[i]  = NULL;
+            free(bs->hm[i]);
+            bs->hm[i] = NULL;
+        }
+    }
     if (bs->cf_qq) {
         for (i = 0; i < bs->ld; ++i) {
             len = bs->hm[i][LENGTH];
@@ -116,6 +124,16 @@ void free_basis_without_hash_table(
         free(bs->hm);
         bs->hm  = NULL;
     }
+    if (bs->cf_64) {
+        for (i = 0; i < bs->ld; ++i) {
+            free(bs->cf_64[i]);
+            free(bs->hm[i]);
+        }
+        free(bs->cf_64);
+        bs->cf_64 = NULL;
+        free(bs->hm);
+        bs->hm  = NULL;
+    }
     if (bs->cf_qq) {
         for (i = 0; i < bs->ld; ++i) {
             len = bs->hm[i][LENGTH];
@@ -183,6 +201,9 @@ bs_t *initialize_basis(
         case 32:
             bs->cf_32  = (cf32_t **)malloc((unsigned long)bs->sz * sizeof(cf32_t *));
             break;
+        case 64:
+            bs->cf_64  = (cf64_t **)malloc((unsigned long)bs->sz * sizeof(cf64_t *));
+            break;
         case 0:
             bs->cf_qq = (mpz_t **)malloc((unsigned long)bs->sz * sizeof(mpz_t *));
             break;
@@ -227,6 +248,11 @@ void check_enlarge_basis(
                         (unsigned long)bs->sz * sizeof(cf32_t *));
                 memset(bs->cf_32+bs->ld, 0, (unsigned long)(bs->sz-bs->ld) * sizeof(cf32_t *));
                 break;
+            case 64:
+                bs->cf_64  = realloc(bs->cf_64,
+                        (unsigned long)bs->sz * sizeof(cf64_t *));
+                memset(bs->cf_64+bs->ld, 0, (unsigned long)(bs->sz-bs->ld) * sizeof(cf64_t *));
+                break;
             case 0:
                 bs->cf_qq = realloc(bs->cf_qq,
                         (unsigned long)bs->sz * sizeof(mpz_t *));
@@ -240,7 +266,7 @@ void check_enlarge_basis(
 /* finite field stuff  --  8 bit */
 static inline void normalize_initial_basis_ff_8(
         bs_t *bs,
-        const uint32_t fc
+        const uint64_t fc
         )
 {
     len_t i, j;
@@ -283,7 +309,7 @@ static inline void normalize_initial_basis_ff_8(
 /* finite field stuff  --  16 bit */
 static inline void normalize_initial_basis_ff_16(
         bs_t *bs,
-        const uint32_t fc
+        const uint64_t fc
         )
 {
     len_t i, j;
@@ -326,7 +352,7 @@ static inline void normalize_initial_basis_ff_16(
 /* finite field stuff  --  32 bit */
 static inline void normalize_initial_basis_ff_32(
         bs_t *bs,
-       const uint32_t fc
+       const uint64_t fc
         )
 {
     len_t i, j;
@@ -365,6 +391,38 @@ static inline void normalize_initial_basis_ff_32(
     }
 }
 
+/* finite field stuff  --  64 bit */
+static inline void normalize_initial_basis_ff_64(
+        bs_t *bs,
+        const uint64_t fc
+        )
+{
+    len_t i, j;
+
+    cf64_t **cf       = bs->cf_64;
+    hm_t * const *hm  = bs->hm;
+    const bl_t ld     = bs->ld;
+
+    for (i = 0; i < ld; ++i) {
+        cf64_t *row = cf[hm[i][COEFFS]];
+
+        const uint64_t inv  = mod_p_inverse_64((int64_t)row[0], (int64_t)fc);
+        const uint64_t ipre = mod_p_shoup_precomp_64(inv, fc);
+        const len_t os      = hm[i][PRELOOP];
+        const len_t len     = hm[i][LENGTH];
+
+        for (j = 0; j < os; ++j) {
+            row[j]  = mod_p_mul_shoup_64(row[j], inv, ipre, fc);
+        }
+        for (j = os; j < len; j += UNROLL) {
+            row[j]    = mod_p_mul_shoup_64(row[j], inv, ipre, fc);
+            row[j+1]  = mod_p_mul_shoup_64(row[j+1], inv, ipre, fc);
+            row[j+2]  = mod_p_mul_shoup_64(row[j+2], inv, ipre, fc);
+            row[j+3]  = mod_p_mul_shoup_64(row[j+3], inv, ipre, fc);
+        }
+    }
+}
+
 /* characteristic zero stuff */
 bs_t *copy_basis_mod_p(
         const bs_t * const gbs,
@@ -439,6 +497,17 @@ bs_t *copy_basis_mod_p(
                 }
             }
             break;
+        case 64:
+            bs->cf_64   = (cf64_t **)malloc((unsigned long)bs->sz * sizeof(cf64_t *));
+            for (i = 0; i < bs->ld; ++i) {
+                idx = gbs->hm[i][COEFFS];
+                bs->cf_64[idx]  =
+                    (cf64_t *)malloc((unsigned long)(gbs->hm[i][LENGTH]) * sizeof(cf64_t));
+                for (j = 0; j < gbs->hm[i][LENGTH]; ++j) {
+                    bs->cf_64[idx][j] = (cf64_t)mpz_fdiv_ui(gbs->cf_qq[idx][j], prime);
+                }
+            }
+            break;
         default:
             exit(1);
     }
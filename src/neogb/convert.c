@@ -646,6 +646,9 @@ static void convert_sparse_matrix_rows_to_basis_elements(
             case 32:
                 bs->cf_32[bl+k] = mat->cf_32[rows[i][COEFFS]];
                 break;
+            case 64:
+                bs->cf_64[bl+k] = mat->cf_64[rows[i][COEFFS]];
+                break;
             default:
                 bs->cf_32[bl+k] = mat->cf_32[rows[i][COEFFS]];
                 break;
@@ -768,6 +771,9 @@ static void convert_sparse_matrix_rows_to_basis_elements_use_sht(
             case 32:
                 bs->cf_32[bl+k] = mat->cf_32[rows[i][COEFFS]];
                 break;
+            case 64:
+                bs->cf_64[bl+k] = mat->cf_64[rows[i][COEFFS]];
+                break;
             default:
                 bs->cf_32[bl+k] = mat->cf_32[rows[i][COEFFS]];
                 break;
@@ -72,6 +72,7 @@ inline omp_int_t omp_get_max_threads(void) { return 1;}
 typedef uint8_t cf8_t;   /* coefficient type finite field (8 bit) */
 typedef uint16_t cf16_t; /* coefficient type finite field (16 bit) */
 typedef uint32_t cf32_t; /* coefficient type finite field (32 bit) */
+typedef uint64_t cf64_t; /* coefficient type finite field (64 bit) */
 typedef uint32_t val_t;  /* core values like hashes */
 typedef val_t hi_t;      /* index of hash table entries*/
 typedef hi_t hm_t;       /* hashed monomials for polynomial entries */
@@ -195,6 +196,7 @@ struct bs_t
     cf8_t **cf_8;   /* coefficients for finite fields (8 bit) */
     cf16_t **cf_16; /* coefficients for finite fields (16 bit) */
     cf32_t **cf_32; /* coefficients for finite fields (32 bit) */
+    cf64_t **cf_64; /* coefficients for finite fields (64 bit) */
     mpz_t **cf_qq;  /* coefficients for rationals (always multiplied such that
                        the denominator is 1) */
 };
@@ -217,6 +219,7 @@ struct mat_t
     cf8_t **cf_8;       /* coefficients for finite fields (8 bit) */
     cf16_t **cf_16;     /* coefficients for finite fields (16 bit) */
     cf32_t **cf_32;     /* coefficients for finite fields (32 bit) */
+    cf64_t **cf_64;     /* coefficients for finite fields (64 bit) */
     mpz_t **cf_qq;      /* coefficients for rationals */
     mpz_t **cf_ab_qq;   /* coefficients for rationals */
     len_t sz;           /* number of rows allocated resp. size */
@@ -229,6 +232,8 @@ struct mat_t
     len_t ncr;          /* number of right columns (in ABCD splicing) */
     len_t rbal;         /* length of reducer binary array */
     deg_t cd;           /* current degree */
+    int32_t cdl;        /* new pivots may store their column indices */
+                        /* additionally as 16 bit differences */
 };
 
 /* signature matrix stuff, stores information from previous and current step */
@@ -255,7 +260,7 @@ struct smat_t
 typedef struct primes_t primes_t;
 struct primes_t
 {
-    uint32_t *p;  /* array of primes */
+    uint64_t *p;  /* array of primes */
     len_t old;    /* old load of array */
     len_t ld;     /* current load of array */
 };
@@ -283,15 +288,22 @@ struct ts_t
 typedef struct td_t td_t;
 struct td_t
 {
-    len_t *rri;   /* reducer rows information in the format */
+    uint8_t *rri; /* reducer rows information in the format */
                   /* basis index1, multiplier1,
-                   * basis index2, multiplier2,... */
-    len_t *tri;   /* to be reduced rows information in the format */
+                   * basis index2, multiplier2,...
+                   * stored as zigzag deltas in varint encoding */
+    uint8_t *tri; /* to be reduced rows information in the format */
                   /* basis index1, multiplier1,
-                   * basis index2, multiplier2,... */
+                   * basis index2, multiplier2,...
+                   * stored as zigzag deltas in varint encoding */
     hm_t *nlms;   /* hashes of new leading monomials represented
                    * in basis hash table */
-    rba_t **rba;  /* reducer binary array for each to be reduced row */
+    uint8_t *rba; /* reducers for each to be reduced row, either as
+                   * sparse gap list or as binary array, see
+                   * construct_trace() */
+    uint64_t rrl; /* number of bytes in rri */
+    uint64_t trl; /* number of bytes in tri */
+    uint64_t rbl; /* number of bytes in rba */
     deg_t deg;    /* degree of elements in trace */
     len_t rld;    /* load of reducer rows information*/
     len_t tld;    /* load of to be reduced rows information*/
@@ -322,6 +334,17 @@ struct trace_t
     len_t rsz;    /* size of rounds stored */
 };
 
+/* trace cache, keeps a learned trace for reusing it on further input
+ * data with the same support, e.g. in batch computations */
+typedef struct tc_t tc_t;
+struct tc_t
+{
+    trace_t *tr;  /* learned trace */
+    exp_t *ev;    /* exponent vectors of the basis hash table the trace
+                   * refers to, in order of insertion */
+    uint64_t sh;  /* hash of the support of the input data */
+    hl_t eld;     /* load of the basis hash table */
+};
 
 /* meta data stuff */
 typedef struct md_t md_t;
@@ -380,13 +403,15 @@ struct md_t
     int32_t mnsel;
     int32_t homogeneous;
     uint32_t gfc; /* global field characteristic */
-    uint32_t fc;
+    uint64_t fc;  /* local field characteristic, may be a 62 bit prime
+                     when computing modular images over the rationals */
     int32_t nev; /* number of elimination variables */
     int32_t mo; /* monomial ordering: 0=DRL, 1=LEX*/
     int32_t laopt;
     int32_t init_hts;
     int32_t nthrds;
     int32_t reset_ht;
+    uint64_t rht_eld; /* basis hash table load at last compaction check */
     int32_t current_rd;
     int32_t current_deg;
     deg_t max_gb_degree;
@@ -429,7 +454,7 @@ struct md_t
  *         ); */
 extern void (*normalize_initial_basis)(
         bs_t *bs,
-        const uint32_t fc
+        const uint64_t fc
         );
 
 extern int (*initial_input_cmp)(
@@ -111,7 +111,7 @@ bs_t *core_gba(
         bs_t *bs,
         md_t *md,
         int32_t *errp,
-        const len_t fc
+        const uint64_t fc
         )
 {
     return core_f4(bs, md, errp, fc);
@@ -129,12 +129,10 @@ int64_t export_results_from_gba(
     md_t **stp
     )
 {
-    if ((*stp)->use_signatures == 0) {
-        return export_results_from_f4(bld, blen, bexp, bcf,
-                mallocp, bsp, bhtp, stp);
-    } else {
-        exit(1);
-    }
+    /* signature based computations store their basis in the same
+     * format as F4 does, see sba_add_new_elements_to_basis() */
+    return export_results_from_f4(bld, blen, bexp, bcf,
+            mallocp, bsp, bhtp, stp);
 }
 
 bs_t *gba_trace_learning_phase(
@@ -144,14 +142,14 @@ bs_t *gba_trace_learning_phase(
         ht_t *gbht,               /* global basis hash table, generated
                                    * in this run, used in upcoming runs */
         md_t *gst,              /* global statistics */
-        const int32_t fc          /* characteristic of field */
+        const uint64_t fc         /* characteristic of field */
         )
 {
-    if (gst->use_signatures == 0) {
-        return f4_trace_learning_phase(trace, tht, ggb, gbht, gst, fc);
-    } else {
-        exit(1);
+    if (gst->use_signatures > 0) {
+        fprintf(stderr, "There is no signature based tracer.\n");
+        return NULL;
     }
+    return f4_trace_learning_phase(trace, tht, ggb, gbht, gst, fc);
 }
 
 bs_t *gba_trace_application_phase(
@@ -161,12 +159,12 @@ bs_t *gba_trace_application_phase(
         ht_t *lbht,               /* global basis hash table, generated
                                    * in this run, used in upcoming runs */
         md_t *gst,              /* global statistics */
-        const int32_t fc          /* characteristic of field */
+        const uint64_t fc         /* characteristic of field */
         )
 {
-    if (gst->use_signatures == 0) {
-        return f4_trace_application_phase(trace, tht, ggb, lbht, gst, fc);
-    } else {
-        exit(1);
+    if (gst->use_signatures > 0) {
+        fprintf(stderr, "There is no signature based tracer.\n");
+        return NULL;
     }
+    return f4_trace_application_phase(trace, tht, ggb, lbht, gst, fc);
 }
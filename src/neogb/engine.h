@@ -53,7 +53,7 @@ bs_t *core_gba(
         bs_t *bs,
         md_t *md,
         int32_t *errp,
-        const len_t fc
+        const uint64_t fc
         );
 
 int64_t export_results_from_gba(
@@ -75,7 +75,7 @@ bs_t *gba_trace_learning_phase(
         ht_t *gbht,               /* global basis hash table, generated
                                    * in this run, used in upcoming runs */
         md_t *gst,              /* global statistics */
-        const int32_t fc          /* characteristic of field */
+        const uint64_t fc         /* characteristic of field */
         );
 
 bs_t *gba_trace_application_phase(
@@ -85,6 +85,6 @@ bs_t *gba_trace_application_phase(
         ht_t *lbht,               /* global basis hash table, generated
                                    * in this run, used in upcoming runs */
         md_t *gst,              /* global statistics */
-        const int32_t fc          /* characteristic of field */
+        const uint64_t fc         /* characteristic of field */
         );
 #endif
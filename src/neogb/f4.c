@@ -130,6 +130,8 @@ static void clear_matrix(
     mat->cf_16  = NULL;
     free(mat->cf_32);
     mat->cf_32  = NULL;
+    free(mat->cf_64);
+    mat->cf_64  = NULL;
     free(mat->cf_qq);
     mat->cf_qq  = NULL;
     free(mat->cf_ab_qq);
@@ -217,6 +219,10 @@ static void intermediate_reduce_basis(
                         free(bs->cf_32[i]);
                         bs->cf_32[i] = bs->cf_32[bs->ld+j];
                         break;
+                    case 64:
+                        free(bs->cf_64[i]);
+                        bs->cf_64[i] = bs->cf_64[bs->ld+j];
+                        break;
                 }
             }
         }
@@ -233,6 +239,9 @@ static void intermediate_reduce_basis(
             case 32:
                 bs->cf_32[i] = NULL;
                 break;
+            case 64:
+                bs->cf_64[i] = NULL;
+                break;
         }
     }
     *hcmp = hcm;
@@ -343,7 +352,7 @@ static int32_t initialize_f4(
         mat_t **matp,
         md_t *gmd,
         bs_t *gbs,
-        len_t fc
+        uint64_t fc
         )
 {
     bs_t *bs     = *lbsp;
@@ -606,7 +615,7 @@ bs_t *core_f4(
         bs_t *gbs,
         md_t *gmd,
         int32_t *errp,
-        const len_t fc
+        const uint64_t fc
         )
 {
     double ct = cputime();
@@ -645,6 +654,13 @@ bs_t *core_f4(
         if (!done && md->trace_level != APPLY_TRACER) {
             done = update(bs, md);
         }
+        /* the basis hash table can only be compacted if no other data
+         * refers to it: modular computations share it between the input
+         * basis, the bases for all primes and the trace */
+        if (!done && bs == gbs && md->trace_level == NO_TRACER) {
+            md->current_rd++;
+            compact_basis_hash_table(bs->ht, bs, md->ps, md);
+        }
 
         print_round_timings(stdout, md, rrt, crt);
     }
@@ -73,13 +73,13 @@ bs_t *core_f4(
         bs_t *gbs,
         md_t *gmd,
         int32_t *errp,
-        const len_t fc
+        const uint64_t fc
         );
 
 bs_t *modular_f4(
         const bs_t * const ggb,       /* global basis */
         ht_t * gbht,                  /* global basis hash table, shared */
         md_t *gst,                  /* global statistics */
-        const uint32_t fc             /* characteristic of field */
+        const uint64_t fc             /* characteristic of field */
         );
 #endif
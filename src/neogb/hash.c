@@ -392,6 +392,42 @@ static void enlarge_hash_table(
     }
 }
 
+/* removes all entries from position eld on from the hash table again */
+static void truncate_hash_table(
+    ht_t *ht,
+    const hi_t eld
+    )
+{
+    hl_t i, j;
+    val_t h, k;
+
+    if (ht->eld <= eld) {
+        return;
+    }
+    memset(ht->hd+eld, 0, (ht->eld-eld) * sizeof(hd_t));
+    ht->eld = eld;
+
+    const hl_t hsz  = ht->hsz;
+    const hi_t mod  = (hi_t)(hsz-1);
+    memset(ht->hmap, 0, hsz * sizeof(hi_t));
+
+    /* reinsert remaining elements */
+    for (i = 1; i < eld; ++i) {
+        h = ht->hd[i].val;
+
+        /* probing */
+        k = h;
+        for (j = 0; j < hsz; ++j) {
+            k = (k+j) & mod;
+            if (ht->hmap[k]) {
+                continue;
+            }
+            ht->hmap[k] = i;
+            break;
+        }
+    }
+}
+
 static inline sdm_t generate_short_divmask(
     const exp_t * const a,
     const ht_t *ht
@@ -1267,6 +1303,140 @@ static void reset_hash_table(
     st->rht_rtime  +=  rt1 - rt0;
 }
 
+static int compaction_cmp(
+        const void *a,
+        const void *b,
+        void *htp
+        )
+{
+    const hi_t ha = *((hi_t *)a);
+    const hi_t hb = *((hi_t *)b);
+
+    return (int)monomial_cmp(hb, ha, (ht_t *)htp);
+}
+
+/* Drops all monomials of the basis hash table that are no longer used by
+ * the basis or the pair set and renumbers the remaining ones in decreasing
+ * monomial order, thus the terms of a basis element are consecutive in
+ * ht->ev and ht->hd. By default this is checked whenever the table's load
+ * has doubled since the last check (small tables are skipped) and the
+ * table is only rebuilt if at most half of its entries are still used. If the user sets st->reset_ht
+ * the table is rebuilt every st->reset_ht rounds instead.
+ * NOTE: Only valid if no other data refers to the basis hash table, in
+ * particular not when tracing or when bs is a modular copy of a basis. */
+static void compact_basis_hash_table(
+    ht_t *ht,
+    bs_t *bs,
+    ps_t *psl,
+    md_t *st
+    )
+{
+    len_t i, j;
+    hl_t k, n;
+
+    const int automatic = st->reset_ht == 2147483647;
+
+    if (automatic) {
+        if (ht->eld < 2 * st->rht_eld || ht->eld < ht->hsz / 16) {
+            return;
+        }
+    } else {
+        if (st->current_rd % st->reset_ht != 0) {
+            return;
+        }
+    }
+
+    /* timings */
+    double ct0, ct1, rt0, rt1;
+    ct0 = cputime();
+    rt0 = realtime();
+
+    spair_t *ps = psl->p;
+
+    const len_t evl = ht->evl;
+    const hl_t esz  = ht->esz;
+    const hl_t eld  = ht->eld;
+    const bl_t bld  = bs->ld;
+    const len_t pld = psl->ld;
+
+    /* mark monomials still in use */
+    hi_t *nh  = (hi_t *)calloc(eld, sizeof(hi_t));
+    for (i = 0; i < bld; ++i) {
+        const hm_t * const row = bs->hm[i];
+        const len_t len = row[LENGTH]+OFFSET;
+        for (j = OFFSET; j < len; ++j) {
+            nh[row[j]] = 1;
+        }
+    }
+    for (i = 0; i < pld; ++i) {
+        nh[ps[i].lcm] = 1;
+    }
+    n = 0;
+    for (k = 1; k < eld; ++k) {
+        n +=  nh[k];
+    }
+    st->rht_eld = eld;
+    if (automatic && 2 * n > eld - 1) {
+        free(nh);
+        return;
+    }
+
+    hi_t *sv  = (hi_t *)malloc((unsigned long)(n+1) * sizeof(hi_t));
+    n = 0;
+    for (k = 1; k < eld; ++k) {
+        if (nh[k] != 0) {
+            sv[n++] = (hi_t)k;
+        }
+    }
+    sort_r(sv, (unsigned long)n, sizeof(hi_t), compaction_cmp, ht);
+
+    exp_t **oev = ht->ev;
+    ht->ev  = malloc(esz * sizeof(exp_t *));
+    exp_t *tmp  = (exp_t *)malloc(
+            (unsigned long)evl * esz * sizeof(exp_t));
+    if (ht->ev == NULL || tmp == NULL) {
+        fprintf(stderr, "Computation needs too much memory on this machine,\n");
+        fprintf(stderr, "compacting hash table failed, esz = %lu\n", (unsigned long)esz);
+        fprintf(stderr, "segmentation fault will follow.\n");
+    }
+    for (k = 0; k < esz; ++k) {
+        ht->ev[k]  = tmp + k*evl;
+    }
+    ht->eld = 1;
+    memset(ht->hmap, 0, ht->hsz * sizeof(hi_t));
+    memset(ht->hd, 0, esz * sizeof(hd_t));
+
+    /* reinsert used monomials, nh maps old to new positions */
+    for (k = 0; k < n; ++k) {
+        nh[sv[k]] = insert_in_hash_table(oev[sv[k]], ht);
+    }
+    for (i = 0; i < bld; ++i) {
+        hm_t *row = bs->hm[i];
+        const len_t len = row[LENGTH]+OFFSET;
+        for (j = OFFSET; j < len; ++j) {
+            row[j] = nh[row[j]];
+        }
+    }
+    for (i = 0; i < pld; ++i) {
+        ps[i].lcm = nh[ps[i].lcm];
+    }
+    /* note: all memory is allocated as a big block, so it is
+     *       enough to free oev[0].       */
+    free(oev[0]);
+    free(oev);
+    free(sv);
+    free(nh);
+
+    st->rht_eld = ht->eld;
+    st->num_rht++;
+
+    /* timings */
+    ct1 = cputime();
+    rt1 = realtime();
+    st->rht_ctime  +=  ct1 - ct0;
+    st->rht_rtime  +=  rt1 - rt0;
+}
+
 /* computes lcm of a and b from ht1 and inserts it in ht2 */
 static inline hi_t get_lcm(
     const hi_t a,
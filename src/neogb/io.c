@@ -1011,7 +1011,7 @@ static int64_t export_julia_data_qq(
     return nterms;
 }
 
-void set_ff_bits(md_t *st, int32_t fc){
+void set_ff_bits(md_t *st, uint64_t fc){
   if (fc == 0) {
     st->ff_bits = 0;
   } else {
@@ -1023,6 +1023,8 @@ void set_ff_bits(md_t *st, int32_t fc){
       } else {
         if (fc < pow(2,32)) {
           st->ff_bits = 32;
+        } else {
+          st->ff_bits = 64;
         }
       }
     }
@@ -1203,6 +1205,11 @@ int32_t check_and_set_meta_data(
     set_ff_bits(st, st->fc);
 
     st->use_signatures  =   use_signatures;
+    /* signature based computations only have 32 bit kernels, these are
+     * also valid for smaller primes */
+    if (st->use_signatures > 0 && (st->ff_bits == 8 || st->ff_bits == 16)) {
+        st->ff_bits = 32;
+    }
 
     /* monomial order */
     if (mon_order != 0 && mon_order != 1) {
@@ -1525,10 +1532,19 @@ int32_t check_and_set_meta_data_trace(
 }
 
 static inline void reset_function_pointers(
-        const uint32_t prime,
+        const uint64_t prime,
         const uint32_t laopt
         )
 {
+    /* primes beyond 32 bit are only used for modular computations
+     * over the rationals, there we only have the exact sparse
+     * linear algebra with 64 bit coefficients at hand. */
+    if (prime >= pow(2,32)) {
+        interreduce_matrix_rows     = interreduce_matrix_rows_ff_64;
+        normalize_initial_basis     = normalize_initial_basis_ff_64;
+        linear_algebra              = exact_sparse_linear_algebra_ff_64;
+        return;
+    }
     if (prime < pow(2,8)) {
         interreduce_matrix_rows     = interreduce_matrix_rows_ff_8;
         export_julia_data           = export_julia_data_ff_8;
@@ -1634,7 +1650,7 @@ static inline void reset_function_pointers(
 
 }
 static inline void reset_trace_function_pointers(
-        const uint32_t prime
+        const uint64_t prime
         )
 {
     if (prime < pow(2,8)) {
@@ -27,7 +27,7 @@ void set_function_pointers(
         const md_t *st
         );
 
-void set_ff_bits(md_t *st, int32_t fc);
+void set_ff_bits(md_t *st, uint64_t fc);
 
 void sort_terms_ff_8(
     cf8_t **cfp,
@@ -251,6 +251,172 @@ static inline cf32_t *normalize_sparse_matrix_row_ff_32(
     return row;
 }
 
+/* Sorted column indices of long new pivot rows only differ by small gaps.
+ * If all gaps fit into 16 bits we append them to the row and mark this in
+ * the otherwise unused degree entry, the reduction kernels then read these
+ * differences instead of the 32 bit column indices, halving the index data
+ * streamed for each application of the pivot. */
+#define CDL     DEG
+#define CDL_MIN 1024
+
+static hm_t *append_column_differences(
+        hm_t *row
+        )
+{
+    len_t j;
+
+    const len_t len = row[LENGTH];
+
+    row[CDL]  = 0;
+    if (len < CDL_MIN) {
+        return row;
+    }
+    for (j = 1; j < len; ++j) {
+        if (row[OFFSET+j] - row[OFFSET+j-1] > 65535) {
+            return row;
+        }
+    }
+    row = realloc(row, (unsigned long)(OFFSET + len + (len+1)/2)
+            * sizeof(hm_t));
+    uint16_t *cd  = (uint16_t *)(row + OFFSET + len);
+    cd[0] = 0;
+    for (j = 1; j < len; ++j) {
+        cd[j] = (uint16_t)(row[OFFSET+j] - row[OFFSET+j-1]);
+    }
+    row[CDL]  = 1;
+
+    return row;
+}
+
+/* dr += mul * row for rows with column differences, see
+ * append_column_differences(), no modular reduction needed for < 2^17 */
+static inline void add_row_by_column_differences_17_bit(
+        int64_t *dr,
+        const hm_t * const dts,
+        const cf32_t * const cfs,
+        const int64_t mul
+        )
+{
+    len_t j;
+
+    const len_t len = dts[LENGTH];
+    const uint16_t * const cd = (uint16_t *)(dts + OFFSET + len);
+    hm_t c  = dts[OFFSET];
+#ifdef HAVE_AVX2
+    int64_t res[4];
+    hm_t ds[8];
+    __m256i redv, mulv, prodv, drv, resv;
+
+    const len_t os  = len % 8;
+    mulv  = _mm256_set1_epi32((uint32_t)mul);
+    for (j = 0; j < os; ++j) {
+        c     +=  cd[j];
+        dr[c] +=  mul * cfs[j];
+    }
+    for (; j < len; j += 8) {
+        ds[0] = c + cd[j];
+        ds[1] = ds[0] + cd[j+1];
+        ds[2] = ds[1] + cd[j+2];
+        ds[3] = ds[2] + cd[j+3];
+        ds[4] = ds[3] + cd[j+4];
+        ds[5] = ds[4] + cd[j+5];
+        ds[6] = ds[5] + cd[j+6];
+        ds[7] = c = ds[6] + cd[j+7];
+        redv  = _mm256_lddqu_si256((__m256i*)(cfs+j));
+        drv   = _mm256_setr_epi64x(dr[ds[1]], dr[ds[3]], dr[ds[5]], dr[ds[7]]);
+        prodv = _mm256_mul_epu32(mulv, _mm256_srli_epi64(redv, 32));
+        resv  = _mm256_add_epi64(drv, prodv);
+        _mm256_storeu_si256((__m256i*)(res), resv);
+        dr[ds[1]] = res[0];
+        dr[ds[3]] = res[1];
+        dr[ds[5]] = res[2];
+        dr[ds[7]] = res[3];
+        prodv = _mm256_mul_epu32(mulv, redv);
+        drv   = _mm256_setr_epi64x(dr[ds[0]], dr[ds[2]], dr[ds[4]], dr[ds[6]]);
+        resv  = _mm256_add_epi64(drv, prodv);
+        _mm256_storeu_si256((__m256i*)(res), resv);
+        dr[ds[0]] = res[0];
+        dr[ds[2]] = res[1];
+        dr[ds[4]] = res[2];
+        dr[ds[6]] = res[3];
+    }
+#else
+    for (j = 0; j < len; ++j) {
+        c     +=  cd[j];
+        dr[c] +=  mul * cfs[j];
+    }
+#endif
+}
+
+/* dr -= mul * row for rows with column differences, see
+ * append_column_differences(), entries are kept non-negative */
+static inline void sub_row_by_column_differences_31_bit(
+        int64_t *dr,
+        const hm_t * const dts,
+        const cf32_t * const cfs,
+        const int64_t mul,
+        const int64_t mod2
+        )
+{
+    len_t j;
+
+    const len_t len = dts[LENGTH];
+    const uint16_t * const cd = (uint16_t *)(dts + OFFSET + len);
+    hm_t c  = dts[OFFSET];
+#ifdef HAVE_AVX2
+    int64_t res[4] __attribute__((aligned(32)));
+    hm_t ds[8];
+    __m256i cmpv, redv, drv, mulv, prodv, resv, rresv;
+    __m256i zerov = _mm256_set1_epi64x(0);
+    __m256i mod2v = _mm256_set1_epi64x(mod2);
+
+    const len_t os  = len % 8;
+    mulv  = _mm256_set1_epi32((uint32_t)mul);
+    for (j = 0; j < os; ++j) {
+        c     +=  cd[j];
+        dr[c] -=  mul * cfs[j];
+        dr[c] +=  (dr[c] >> 63) & mod2;
+    }
+    for (; j < len; j += 8) {
+        ds[0] = c + cd[j];
+        ds[1] = ds[0] + cd[j+1];
+        ds[2] = ds[1] + cd[j+2];
+        ds[3] = ds[2] + cd[j+3];
+        ds[4] = ds[3] + cd[j+4];
+        ds[5] = ds[4] + cd[j+5];
+        ds[6] = ds[5] + cd[j+6];
+        ds[7] = c = ds[6] + cd[j+7];
+        redv  = _mm256_loadu_si256((__m256i*)(cfs+j));
+        drv   = _mm256_setr_epi64x(dr[ds[1]], dr[ds[3]], dr[ds[5]], dr[ds[7]]);
+        prodv = _mm256_mul_epu32(mulv, _mm256_srli_epi64(redv, 32));
+        resv  = _mm256_sub_epi64(drv, prodv);
+        cmpv  = _mm256_cmpgt_epi64(zerov, resv);
+        rresv = _mm256_add_epi64(resv, _mm256_and_si256(cmpv, mod2v));
+        _mm256_store_si256((__m256i*)(res), rresv);
+        dr[ds[1]] = res[0];
+        dr[ds[3]] = res[1];
+        dr[ds[5]] = res[2];
+        dr[ds[7]] = res[3];
+        prodv = _mm256_mul_epu32(mulv, redv);
+        drv   = _mm256_setr_epi64x(dr[ds[0]], dr[ds[2]], dr[ds[4]], dr[ds[6]]);
+        resv  = _mm256_sub_epi64(drv, prodv);
+        cmpv  = _mm256_cmpgt_epi64(zerov, resv);
+        rresv = _mm256_add_epi64(resv, _mm256_and_si256(cmpv, mod2v));
+        _mm256_store_si256((__m256i*)(res), rresv);
+        dr[ds[0]] = res[0];
+        dr[ds[2]] = res[1];
+        dr[ds[4]] = res[2];
+        dr[ds[6]] = res[3];
+    }
+#else
+    for (j = 0; j < len; ++j) {
+        c     +=  cd[j];
+        dr[c] -=  mul * cfs[j];
+        dr[c] +=  (dr[c] >> 63) & mod2;
+    }
+#endif
+}
+
 static inline cf32_t *adjust_multiplier_sparse_matrix_row_ff_32(
         cf32_t *row,
         const cf32_t * const cfs,
@@ -360,6 +526,14 @@ static hm_t *reduce_dense_row_by_known_pivots_sparse_17_bit(
             }
         } else {
             cfs   = mcf[dts[COEFFS]];
+            if (mat->cdl != 0 && dts[CDL] != 0) {
+                add_row_by_column_differences_17_bit(dr, dts, cfs, mul);
+                dr[i] = 0;
+                st->application_nr_mult +=  dts[LENGTH] / 1000.0;
+                st->application_nr_add  +=  dts[LENGTH] / 1000.0;
+                st->application_nr_red++;
+                continue;
+            }
         }
 #ifdef HAVE_AVX2
         const len_t len = dts[LENGTH];
@@ -891,6 +1065,14 @@ static hm_t *reduce_dense_row_by_known_pivots_sparse_31_bit(
             }
         } else {
             cfs   = mcf[dts[COEFFS]];
+            if (mat->cdl != 0 && dts[CDL] != 0) {
+                sub_row_by_column_differences_31_bit(dr, dts, cfs, mul, mod2);
+                dr[i] = 0;
+                st->application_nr_mult +=  dts[LENGTH] / 1000.0;
+                st->application_nr_add  +=  dts[LENGTH] / 1000.0;
+                st->application_nr_red++;
+                continue;
+            }
         }
 #ifdef HAVE_AVX2
         const len_t len = dts[LENGTH];
@@ -2237,6 +2419,14 @@ static void probabilistic_sparse_reduced_echelon_form_ff_32(
     st->np = mat->np = mat->nr = mat->sz = npivs;
 }
 
+/* Rows are sorted by increasing signature, a row may only be reduced by
+ * pivots coming from rows of smaller signature. We handle the rows in blocks:
+ * First all rows of a block whose leading term is reducible are reduced in
+ * parallel by the pivots of the former blocks. Afterwards the rows of the
+ * block are finished one after the other in signature order w.r.t. the new
+ * pivots of the block. A fully reduced row does not depend on the order in
+ * which pivots are applied, thus we get the same result as with a sequential
+ * reduction. */
 static void sba_echelon_form_ff_32(
         smat_t *smat,
         crit_t *syz,
@@ -2244,68 +2434,172 @@ static void sba_echelon_form_ff_32(
         const ht_t * const ht
         )
 {
-    len_t i, j;
+    len_t i, j, k, l;
 
     /* row index, might differ from i if we encounter zero reductions */
     len_t ri;
 
     const len_t nc  = smat->nc;
     const len_t nr  = smat->cld;
+    /* rows per block */
+    const len_t rpb = 16 * st->nthrds;
 
     /* we fill in all known lead terms in pivs */
     hm_t **pivs = (hm_t **)calloc((unsigned long)nc, sizeof(hm_t *));
 
     int64_t *dr  = (int64_t *)malloc(
-            (unsigned long)nc * sizeof(int64_t));
-
-    /* TODO: At the moment I do not see how to make this parallel due to
-     * reduction dependencies on the signatures. */
-    for (ri = 0, i = 0; i < nr; ++i) {
-        hm_t *npiv      = smat->cr[i];
-        cf32_t *cfs     = smat->pc32[npiv[SM_CFS]];
-        const hm_t sm   = npiv[SM_SMON];
-        const len_t si  = npiv[SM_SIDX];
-        const len_t os  = npiv[SM_PRE];
-        const len_t len = npiv[SM_LEN];
-        const hm_t * const ds = npiv + SM_OFFSET;
-        memset(dr, 0, (unsigned long)nc * sizeof(int64_t));
-        for (j = 0; j < os; ++j) {
-            dr[ds[j]]  = (int64_t)cfs[j];
-        }
-        for (; j < len; j += UNROLL) {
-            dr[ds[j]]    = (int64_t)cfs[j];
-            dr[ds[j+1]]  = (int64_t)cfs[j+1];
-            dr[ds[j+2]]  = (int64_t)cfs[j+2];
-            dr[ds[j+3]]  = (int64_t)cfs[j+3];
-        }
-        const len_t offset = npiv[SM_OFFSET];
-        free(npiv);
-        npiv        = NULL;
-        smat->cr[i] = NULL;
-        /* printf("reducing row %u || %u | %u -- ", i, sm, si);
-         * for (int ii = 0; ii < ht->evl; ++ii) {
-         *     printf("%u ", ht->ev[sm][ii]);
-         * }
-         * printf("\n"); */
-        npiv = sba_reduce_dense_row_by_known_pivots_sparse_ff_32(
-                dr, smat, pivs, offset, sm, si, ri, st);
-        if (!npiv) {
-            /* row s-reduced to zero, add syzygy and go on with next row */
-            add_syzygy_schreyer(syz, sm, si, ht);
-            continue;
-        }
+            (unsigned long)(st->nthrds * nc) * sizeof(int64_t));
 
-        ri++;
-        /* normalize coefficient array
-         * NOTE: this has to be done here, otherwise the reduction may
-         * lead to wrong results in a parallel computation since other
-         * threads might directly use the new pivot once it is synced. */
-        if (smat->cc32[npiv[SM_CFS]][0] != 1) {
-            normalize_sparse_matrix_row_ff_32(
-                    smat->cc32[npiv[SM_CFS]], npiv[SM_PRE],
-                    npiv[SM_LEN], st->fc);
+    /* signature data of the rows of a block and their state:
+     * 0 -> not yet reduced, 1 -> reduced by former pivots, 2 -> zero row */
+    hm_t *bsm   = (hm_t *)malloc((unsigned long)rpb * sizeof(hm_t));
+    len_t *bsi  = (len_t *)malloc((unsigned long)rpb * sizeof(len_t));
+    int8_t *bst = (int8_t *)malloc((unsigned long)rpb * sizeof(int8_t));
+
+    for (ri = 0, l = 0; l < nr; l += rpb) {
+        const len_t nrb = nr - l < rpb ? nr - l : rpb;
+
+#pragma omp parallel for num_threads(st->nthrds) \
+    private(i, j) schedule(dynamic)
+        for (i = 0; i < nrb; ++i) {
+            hm_t *npiv  = smat->cr[l+i];
+            bsm[i]      = npiv[SM_SMON];
+            bsi[i]      = npiv[SM_SIDX];
+            bst[i]      = 0;
+            /* whether such a row is reduced at all depends on the
+             * new pivots of this block, we handle it later on */
+            if (pivs[npiv[SM_OFFSET]] == NULL) {
+                continue;
+            }
+            int64_t *drl    = dr + (omp_get_thread_num() * nc);
+            cf32_t *cfs     = smat->pc32[npiv[SM_CFS]];
+            const len_t os  = npiv[SM_PRE];
+            const len_t len = npiv[SM_LEN];
+            const hm_t * const ds = npiv + SM_OFFSET;
+            memset(drl, 0, (unsigned long)nc * sizeof(int64_t));
+            for (j = 0; j < os; ++j) {
+                drl[ds[j]]  = (int64_t)cfs[j];
+            }
+            for (; j < len; j += UNROLL) {
+                drl[ds[j]]    = (int64_t)cfs[j];
+                drl[ds[j+1]]  = (int64_t)cfs[j+1];
+                drl[ds[j+2]]  = (int64_t)cfs[j+2];
+                drl[ds[j+3]]  = (int64_t)cfs[j+3];
+            }
+            const len_t offset = npiv[SM_OFFSET];
+            free(npiv);
+            smat->cr[l+i] = NULL;
+            /* the row keeps its index until it is finished */
+            npiv = sba_reduce_dense_row_by_known_pivots_sparse_ff_32(
+                    drl, smat, pivs, offset, bsm[i], bsi[i], l+i, st);
+            bst[i]  = npiv == NULL ? 2 : 1;
+        }
+
+        for (i = 0; i < nrb; ++i) {
+            hm_t *npiv  = smat->cr[l+i];
+            const hm_t sm   = bsm[i];
+            const len_t si  = bsi[i];
+            if (bst[i] == 2) {
+                /* row s-reduced to zero, add syzygy and go on with next row */
+                add_syzygy_schreyer(syz, sm, si, ht);
+                continue;
+            }
+            if (bst[i] == 1) {
+                /* the row is reduced by all pivots of former blocks, it only
+                 * has to be reduced further if it has a term which is a
+                 * leading term of a new pivot of this block */
+                const len_t len = npiv[SM_LEN];
+                const hm_t * const ds = npiv + SM_OFFSET;
+                for (j = 0; j < len; ++j) {
+                    if (pivs[ds[j]] != NULL) {
+                        break;
+                    }
+                }
+                if (j == len) {
+                    smat->cr[l+i]   = NULL;
+                    smat->cr[ri]    = npiv;
+                    smat->cc32[ri]  = smat->cc32[l+i];
+                    if (ri != l+i) {
+                        smat->cc32[l+i] = NULL;
+                    }
+                    npiv[SM_CFS]  = ri;
+                } else {
+                    cf32_t *cfs = smat->cc32[l+i];
+                    memset(dr, 0, (unsigned long)nc * sizeof(int64_t));
+                    for (j = 0; j < len; ++j) {
+                        dr[ds[j]] = (int64_t)cfs[j];
+                    }
+                    /* the leading term is already reduced, so we have to
+                     * reduce the full row, even if its leading term is no
+                     * pivot: start one column before the leading term */
+                    const len_t offset = npiv[SM_OFFSET];
+                    free(npiv);
+                    free(cfs);
+                    smat->cr[l+i]   = NULL;
+                    smat->cc32[l+i] = NULL;
+                    npiv = sba_reduce_dense_row_by_known_pivots_sparse_ff_32(
+                            dr, smat, pivs, offset-1, sm, si, ri, st);
+                }
+            } else {
+                cf32_t *cfs     = smat->pc32[npiv[SM_CFS]];
+                const len_t os  = npiv[SM_PRE];
+                const len_t len = npiv[SM_LEN];
+                const hm_t * const ds = npiv + SM_OFFSET;
+                const len_t offset = npiv[SM_OFFSET];
+                if (pivs[offset] == NULL) {
+                    /* leading term not reducible, the row stays as it is */
+                    cf32_t *cf  = (cf32_t *)malloc(
+                            (unsigned long)len * sizeof(cf32_t));
+                    hm_t *rs    = npiv + SM_OFFSET;
+                    for (j = 0, k = 0; j < len; ++j) {
+                        if (cfs[j] != 0) {
+                            rs[k] = ds[j];
+                            cf[k] = cfs[j];
+                            k++;
+                        }
+                    }
+                    smat->cr[l+i] = NULL;
+                    npiv  = realloc(npiv,
+                            (unsigned long)(k+SM_OFFSET) * sizeof(hm_t));
+                    npiv[SM_CFS]  = ri;
+                    npiv[SM_PRE]  = k % UNROLL;
+                    npiv[SM_LEN]  = k;
+                    smat->cr[ri]    = npiv;
+                    smat->cc32[ri]  = cf;
+                } else {
+                    memset(dr, 0, (unsigned long)nc * sizeof(int64_t));
+                    for (j = 0; j < os; ++j) {
+                        dr[ds[j]]  = (int64_t)cfs[j];
+                    }
+                    for (; j < len; j += UNROLL) {
+                        dr[ds[j]]    = (int64_t)cfs[j];
+                        dr[ds[j+1]]  = (int64_t)cfs[j+1];
+                        dr[ds[j+2]]  = (int64_t)cfs[j+2];
+                        dr[ds[j+3]]  = (int64_t)cfs[j+3];
+                    }
+                    free(npiv);
+                    smat->cr[l+i] = NULL;
+                    npiv = sba_reduce_dense_row_by_known_pivots_sparse_ff_32(
+                            dr, smat, pivs, offset, sm, si, ri, st);
+                }
+            }
+            if (!npiv) {
+                /* row s-reduced to zero, add syzygy and go on with next row */
+                add_syzygy_schreyer(syz, sm, si, ht);
+                continue;
+            }
+
+            ri++;
+            /* normalize coefficient array
+             * NOTE: this has to be done here, pivots of this block are
+             * already used for the next rows of the block. */
+            if (smat->cc32[npiv[SM_CFS]][0] != 1) {
+                normalize_sparse_matrix_row_ff_32(
+                        smat->cc32[npiv[SM_CFS]], npiv[SM_PRE],
+                        npiv[SM_LEN], st->fc);
+            }
+            pivs[npiv[SM_OFFSET]] = npiv;
         }
-        pivs[npiv[SM_OFFSET]] = npiv;
     }
 
     /* free initial coefficients coming from previous degree matrix */
@@ -2318,6 +2612,9 @@ static void sba_echelon_form_ff_32(
     smat->nz  = smat->cld - ri;
     smat->cld = ri;
 
+    free(bsm);
+    free(bsi);
+    free(bst);
     free(pivs);
     pivs = NULL;
     free(dr);
@@ -2349,6 +2646,14 @@ static void exact_sparse_reduced_echelon_form_ff_32(
 
     int64_t *dr  = (int64_t *)malloc(
             (unsigned long)(st->nthrds * ncols) * sizeof(int64_t));
+    /* new pivots get their column differences, only for prime fields
+     * for which we have kernels handling these, the scalar decoder is
+     * slower than reading the plain rows */
+#ifdef HAVE_AVX2
+    mat->cdl  = st->fc < pow(2, 31) ? 1 : 0;
+#else
+    mat->cdl  = 0;
+#endif
     /* mo need to have any sharing dependencies on parallel computation,
      * no data to be synchronized at this step of the linear algebra */
 #pragma omp parallel for num_threads(st->nthrds) \
@@ -2396,6 +2701,9 @@ static void exact_sparse_reduced_echelon_form_ff_32(
                     normalize_sparse_matrix_row_ff_32(
                             mat->cf_32[npiv[COEFFS]], npiv[PRELOOP], npiv[LENGTH], st->fc);
                 }
+                if (mat->cdl != 0) {
+                    npiv  = mat->tr[i] = append_column_differences(npiv);
+                }
                 k   = __sync_bool_compare_and_swap(&pivs[npiv[OFFSET]], NULL, npiv);
                 cfs = mat->cf_32[npiv[COEFFS]];
             } while (!k);
@@ -2407,6 +2715,7 @@ static void exact_sparse_reduced_echelon_form_ff_32(
             free(pivs[i]);
             pivs[i] = NULL;
         }
+        mat->cdl  = 0;
         mat->np = 0;
         if (st->info_level > 0) {
             fprintf(stderr, "Zero reduction while applying tracer, bad prime.\n");
@@ -2427,6 +2736,9 @@ static void exact_sparse_reduced_echelon_form_ff_32(
 
     len_t npivs = 0; /* number of new pivots */
 
+    /* the interreduced pivots are stored without column differences */
+    mat->cdl  = 0;
+
     dr      = realloc(dr, (unsigned long)ncols * sizeof(int64_t));
     mat->tr = realloc(mat->tr, (unsigned long)ncr * sizeof(hm_t *));
 
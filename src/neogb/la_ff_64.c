@@ -0,0 +1,411 @@
+/* This file is part of msolve.
+ *
+ * msolve is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * msolve is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with msolve.  If not, see <https://www.gnu.org/licenses/>
+ *
+ * Authors:
+ * Jérémy Berthomieu
+ * Christian Eder
+ * Mohab Safey El Din */
+
+#include "data.h"
+
+/* Linear algebra for prime fields with characteristic 2^32 <= p < 2^63.
+ * These fields are only used for modular computations over the rationals,
+ * thus we only provide the exact sparse reduced echelon form (incl.
+ * learning and applying tracers) and the final interreduction.
+ *
+ * Coefficients of the dense row are kept reduced in [0,p), each reducer
+ * row is multiplied by a fixed multiplier, so we use Shoup's modular
+ * multiplication with one precomputed quotient per reducer row. */
+
+static inline cf64_t *normalize_sparse_matrix_row_ff_64(
+        cf64_t *row,
+        const len_t os,
+        const len_t len,
+        const uint64_t fc
+        )
+{
+    len_t i;
+
+    const uint64_t inv  = mod_p_inverse_64((int64_t)row[0], (int64_t)fc);
+    const uint64_t ipre = mod_p_shoup_precomp_64(inv, fc);
+
+    for (i = 0; i < os; ++i) {
+        row[i]  = mod_p_mul_shoup_64(row[i], inv, ipre, fc);
+    }
+    /* we need to set i to os since os < 1 is possible */
+    for (i = os; i < len; i += UNROLL) {
+        row[i]    = mod_p_mul_shoup_64(row[i], inv, ipre, fc);
+        row[i+1]  = mod_p_mul_shoup_64(row[i+1], inv, ipre, fc);
+        row[i+2]  = mod_p_mul_shoup_64(row[i+2], inv, ipre, fc);
+        row[i+3]  = mod_p_mul_shoup_64(row[i+3], inv, ipre, fc);
+    }
+    row[0]  = 1;
+
+    return row;
+}
+
+static hm_t *reduce_dense_row_by_known_pivots_sparse_ff_64(
+        uint64_t *dr,
+        mat_t *mat,
+        const bs_t * const bs,
+        hm_t *const *pivs,
+        const hi_t dpiv,    /* pivot of dense row at the beginning */
+        const hm_t tmp_pos, /* position of new coeffs array in tmpcf */
+        const len_t mh,     /* multiplier hash for tracing */
+        const len_t bi,     /* basis index of generating element */
+        const len_t tr,     /* trace data? */
+        md_t *st
+        )
+{
+    hi_t i, j, k;
+    cf64_t *cfs;
+    hm_t *dts;
+    uint64_t tmp;
+    int64_t np = -1;
+    const uint64_t mod          = st->fc;
+    const len_t ncols           = mat->nc;
+    const len_t ncl             = mat->ncl;
+    cf64_t * const * const mcf  = mat->cf_64;
+    rba_t *rba;
+    if (tr > 0) {
+        rba = mat->rba[tmp_pos];
+    } else {
+        rba = NULL;
+    }
+
+    k = 0;
+    for (i = dpiv; i < ncols; ++i) {
+        if (dr[i] == 0) {
+            continue;
+        }
+        if (pivs[i] == NULL) {
+            if (np == -1) {
+                np  = i;
+            }
+            k++;
+            continue;
+        }
+
+        /* found reducer row, get multiplier */
+        const uint64_t mul    = mod - dr[i];
+        const uint64_t mulpre = mod_p_shoup_precomp_64(mul, mod);
+        dts   = pivs[i];
+        if (i < ncl) {
+            cfs   = bs->cf_64[dts[COEFFS]];
+            /* set corresponding bit of reducer in reducer bit array */
+            if (tr > 0) {
+                rba[i/32] |= 1U << (i % 32);
+            }
+        } else {
+            cfs   = mcf[dts[COEFFS]];
+        }
+        const len_t os  = dts[PRELOOP];
+        const len_t len = dts[LENGTH];
+        const hm_t * const ds = dts + OFFSET;
+        for (j = 0; j < os; ++j) {
+            tmp         =   dr[ds[j]] + mod_p_mul_shoup_64(cfs[j], mul, mulpre, mod);
+            dr[ds[j]]   =   tmp >= mod ? tmp - mod : tmp;
+        }
+        for (; j < len; j += UNROLL) {
+            tmp           =   dr[ds[j]] + mod_p_mul_shoup_64(cfs[j], mul, mulpre, mod);
+            dr[ds[j]]     =   tmp >= mod ? tmp - mod : tmp;
+            tmp           =   dr[ds[j+1]] + mod_p_mul_shoup_64(cfs[j+1], mul, mulpre, mod);
+            dr[ds[j+1]]   =   tmp >= mod ? tmp - mod : tmp;
+            tmp           =   dr[ds[j+2]] + mod_p_mul_shoup_64(cfs[j+2], mul, mulpre, mod);
+            dr[ds[j+2]]   =   tmp >= mod ? tmp - mod : tmp;
+            tmp           =   dr[ds[j+3]] + mod_p_mul_shoup_64(cfs[j+3], mul, mulpre, mod);
+            dr[ds[j+3]]   =   tmp >= mod ? tmp - mod : tmp;
+        }
+        dr[i] = 0;
+        st->application_nr_mult +=  len / 1000.0;
+        st->application_nr_add  +=  len / 1000.0;
+        st->application_nr_red++;
+    }
+
+    if (k == 0) {
+        return NULL;
+    }
+
+    hm_t *row   = (hm_t *)malloc((unsigned long)(k+OFFSET) * sizeof(hm_t));
+    cf64_t *cf  = (cf64_t *)malloc((unsigned long)(k) * sizeof(cf64_t));
+    j = 0;
+    hm_t *rs  = row + OFFSET;
+    for (i = np; i < ncols; ++i) {
+        if (dr[i] != 0) {
+            rs[j] = (hm_t)i;
+            cf[j] = (cf64_t)dr[i];
+            j++;
+        }
+    }
+    row[BINDEX]         = bi;
+    row[MULT]           = mh;
+    row[COEFFS]         = tmp_pos;
+    row[PRELOOP]        = j % UNROLL;
+    row[LENGTH]         = j;
+    mat->cf_64[tmp_pos] = cf;
+
+    return row;
+}
+
+static void exact_sparse_reduced_echelon_form_ff_64(
+        mat_t *mat,
+        const bs_t * const bs,
+        md_t *st
+        )
+{
+    len_t i = 0, j, k;
+    hi_t sc = 0;    /* starting column */
+
+    const len_t ncols = mat->nc;
+    const len_t nrl   = mat->nrl;
+    const len_t ncr   = mat->ncr;
+    const len_t ncl   = mat->ncl;
+
+    len_t bad_prime = 0;
+
+    /* we fill in all known lead terms in pivs */
+    hm_t **pivs   = (hm_t **)calloc((unsigned long)ncols, sizeof(hm_t *));
+    memcpy(pivs, mat->rr, (unsigned long)mat->nru * sizeof(hm_t *));
+
+    /* unkown pivot rows we have to reduce with the known pivots first */
+    hm_t **upivs  = mat->tr;
+
+    uint64_t *dr  = (uint64_t *)malloc(
+            (unsigned long)(st->nthrds * ncols) * sizeof(uint64_t));
+    /* mo need to have any sharing dependencies on parallel computation,
+     * no data to be synchronized at this step of the linear algebra */
+#pragma omp parallel for num_threads(st->nthrds) \
+    private(i, j, k, sc) \
+    schedule(dynamic)
+    for (i = 0; i < nrl; ++i) {
+        if (bad_prime == 0) {
+            uint64_t *drl   = dr + (omp_get_thread_num() * ncols);
+            hm_t *npiv      = upivs[i];
+            cf64_t *cfs     = bs->cf_64[npiv[COEFFS]];
+            const len_t os  = npiv[PRELOOP];
+            const len_t len = npiv[LENGTH];
+            const len_t bi  = npiv[BINDEX];
+            const len_t mh  = npiv[MULT];
+            const hm_t * const ds = npiv + OFFSET;
+            k = 0;
+            memset(drl, 0, (unsigned long)ncols * sizeof(uint64_t));
+            for (j = 0; j < os; ++j) {
+                drl[ds[j]]  = cfs[j];
+            }
+            for (; j < len; j += UNROLL) {
+                drl[ds[j]]    = cfs[j];
+                drl[ds[j+1]]  = cfs[j+1];
+                drl[ds[j+2]]  = cfs[j+2];
+                drl[ds[j+3]]  = cfs[j+3];
+            }
+            cfs = NULL;
+            do {
+                sc  = npiv[OFFSET];
+                free(npiv);
+                free(cfs);
+                npiv  = mat->tr[i] = reduce_dense_row_by_known_pivots_sparse_ff_64(
+                        drl, mat, bs, pivs, sc, i, mh, bi, st->trace_level == LEARN_TRACER, st);
+                if (!npiv) {
+                    if (st->trace_level == APPLY_TRACER) {
+                        bad_prime = 1;
+                    }
+                    break;
+                }
+                /* normalize coefficient array
+                 * NOTE: this has to be done here, otherwise the reduction may
+                 * lead to wrong results in a parallel computation since other
+                 * threads might directly use the new pivot once it is synced. */
+                if (mat->cf_64[npiv[COEFFS]][0] != 1) {
+                    normalize_sparse_matrix_row_ff_64(
+                            mat->cf_64[npiv[COEFFS]], npiv[PRELOOP], npiv[LENGTH], st->fc);
+                }
+                k   = __sync_bool_compare_and_swap(&pivs[npiv[OFFSET]], NULL, npiv);
+                cfs = mat->cf_64[npiv[COEFFS]];
+            } while (!k);
+        }
+    }
+
+    if (bad_prime == 1) {
+        for (i = 0; i < ncl+ncr; ++i) {
+            free(pivs[i]);
+            pivs[i] = NULL;
+        }
+        mat->np = 0;
+        if (st->info_level > 0) {
+            fprintf(stderr, "Zero reduction while applying tracer, bad prime.\n");
+        }
+        return;
+    }
+
+    /* construct the trace */
+    if (st->trace_level == LEARN_TRACER) {
+        construct_trace(st->tr, mat);
+    }
+
+    /* we do not need the old pivots anymore */
+    for (i = 0; i < ncl; ++i) {
+        free(pivs[i]);
+        pivs[i] = NULL;
+    }
+
+    len_t npivs = 0; /* number of new pivots */
+
+    dr      = realloc(dr, (unsigned long)ncols * sizeof(uint64_t));
+    mat->tr = realloc(mat->tr, (unsigned long)ncr * sizeof(hm_t *));
+
+    /* interreduce new pivots */
+    cf64_t *cfs;
+    hm_t cf_array_pos;
+    for (i = 0; i < ncr; ++i) {
+        k = ncols-1-i;
+        if (pivs[k]) {
+            memset(dr, 0, (unsigned long)ncols * sizeof(uint64_t));
+            cfs = mat->cf_64[pivs[k][COEFFS]];
+            cf_array_pos    = pivs[k][COEFFS];
+            const len_t os  = pivs[k][PRELOOP];
+            const len_t len = pivs[k][LENGTH];
+            const len_t bi  = pivs[k][BINDEX];
+            const len_t mh  = pivs[k][MULT];
+            const hm_t * const ds = pivs[k] + OFFSET;
+            sc  = ds[0];
+            for (j = 0; j < os; ++j) {
+                dr[ds[j]] = cfs[j];
+            }
+            for (; j < len; j += UNROLL) {
+                dr[ds[j]]    = cfs[j];
+                dr[ds[j+1]]  = cfs[j+1];
+                dr[ds[j+2]]  = cfs[j+2];
+                dr[ds[j+3]]  = cfs[j+3];
+            }
+            free(pivs[k]);
+            free(cfs);
+            pivs[k] = NULL;
+            pivs[k] = mat->tr[npivs++] =
+                reduce_dense_row_by_known_pivots_sparse_ff_64(
+                        dr, mat, bs, pivs, sc, cf_array_pos, mh, bi, 0, st);
+        }
+    }
+    free(pivs);
+    pivs  = NULL;
+    free(dr);
+    dr  = NULL;
+
+    mat->tr = realloc(mat->tr, (unsigned long)npivs * sizeof(hi_t *));
+    st->np = mat->np = mat->nr = mat->sz = npivs;
+}
+
+static void exact_sparse_linear_algebra_ff_64(
+        mat_t *mat,
+        const bs_t * const bs,
+        md_t *st
+        )
+{
+    /* timings */
+    double ct0, ct1, rt0, rt1;
+    ct0 = cputime();
+    rt0 = realtime();
+
+    /* allocate temporary storage space for sparse
+     * coefficients of new pivot rows */
+    mat->cf_64  = realloc(mat->cf_64,
+            (unsigned long)mat->nrl * sizeof(cf64_t *));
+    exact_sparse_reduced_echelon_form_ff_64(mat, bs, st);
+
+    /* timings */
+    ct1 = cputime();
+    rt1 = realtime();
+    st->la_ctime  +=  ct1 - ct0;
+    st->la_rtime  +=  rt1 - rt0;
+
+    st->num_zerored += (mat->nrl - mat->np);
+    if (st->info_level > 1) {
+        printf("%9d new %7d zero", mat->np, mat->nrl - mat->np);
+        fflush(stdout);
+    }
+}
+
+static void interreduce_matrix_rows_ff_64(
+        mat_t *mat,
+        bs_t *bs,
+        md_t *st,
+        const int free_basis
+        )
+{
+    len_t i, j, k, l;
+
+    const len_t nrows = mat->nr;
+    const len_t ncols = mat->nc;
+
+    /* adjust displaying timings for statistic printout */
+    if (st->info_level > 1) {
+        printf("                          ");
+    }
+
+    mat->tr = realloc(mat->tr, (unsigned long)ncols * sizeof(hm_t *));
+
+    mat->cf_64  = realloc(mat->cf_64,
+            (unsigned long)ncols * sizeof(cf64_t *));
+    memset(mat->cf_64, 0, (unsigned long)ncols * sizeof(cf64_t *));
+    hm_t **pivs = (hm_t **)calloc((unsigned long)ncols, sizeof(hm_t *));
+    /* copy coefficient arrays from basis in matrix, maybe
+     * several rows need the same coefficient arrays, but we
+     * cannot share them here. */
+    for (i = 0; i < nrows; ++i) {
+        pivs[mat->rr[i][OFFSET]]  = mat->rr[i];
+    }
+
+    uint64_t *dr = (uint64_t *)malloc((unsigned long)ncols * sizeof(uint64_t));
+    /* interreduce new pivots */
+    cf64_t *cfs;
+    /* starting column, coefficient array position in tmpcf */
+    hm_t sc;
+    k = nrows - 1;
+    for (i = 0; i < ncols; ++i) {
+        l = ncols-1-i;
+        if (pivs[l] != NULL) {
+            memset(dr, 0, (unsigned long)ncols * sizeof(uint64_t));
+            cfs = bs->cf_64[pivs[l][COEFFS]];
+            const len_t os  = pivs[l][PRELOOP];
+            const len_t len = pivs[l][LENGTH];
+            const len_t bi  = pivs[l][BINDEX];
+            const len_t mh  = pivs[l][MULT];
+            const hm_t * const ds = pivs[l] + OFFSET;
+            sc  = ds[0];
+            for (j = 0; j < os; ++j) {
+                dr[ds[j]] = cfs[j];
+            }
+            for (; j < len; j += UNROLL) {
+                dr[ds[j]]   = cfs[j];
+                dr[ds[j+1]] = cfs[j+1];
+                dr[ds[j+2]] = cfs[j+2];
+                dr[ds[j+3]] = cfs[j+3];
+            }
+            free(pivs[l]);
+            pivs[l] = NULL;
+            pivs[l] = mat->tr[k--] =
+                reduce_dense_row_by_known_pivots_sparse_ff_64(
+                        dr, mat, bs, pivs, sc, l, mh, bi, 0,  st);
+        }
+    }
+    if (free_basis != 0) {
+        /* free now all polynomials in the basis and reset bs->ld to 0. */
+        free_basis_elements(bs);
+    }
+    free(mat->rr);
+    mat->rr = NULL;
+    mat->np = nrows;
+    free(pivs);
+    free(dr);
+}
@@ -22,7 +22,7 @@
 #include "meta_data.h"
 static md_t *copy_meta_data(
         const md_t * const gmd,
-        const int32_t prime
+        const uint64_t prime
         )
 {
     md_t *md = (md_t *)malloc(sizeof(md_t));
@@ -40,6 +40,8 @@ static md_t *copy_meta_data(
         } else {
             if (md->fc < pow(2,31)) {
                 md->ff_bits = 32;
+            } else {
+                md->ff_bits = 64;
             }
         }
     }
@@ -109,7 +111,7 @@ void print_initial_statistics(
         fprintf(file, "#variables             %11d\n", st->nvars);
         fprintf(file, "#equations             %11d\n", st->ngens);
         fprintf(file, "#invalid equations     %11d\n", st->ngens_invalid);
-        fprintf(file, "field characteristic   %11u\n", st->fc);
+        fprintf(file, "field characteristic   %11lu\n", (unsigned long)st->fc);
         fprintf(file, "homogeneous input?     %11d\n", st->homogeneous);
         fprintf(file, "signature-based computation %6d\n", st->use_signatures);
         if (st->mo == 0 && st->nev == 0) {
@@ -125,7 +127,7 @@ void print_initial_statistics(
             fprintf(file, "monomial order           DONT KNOW\n");
         }
         if (st->reset_ht == 2147483647) {
-            fprintf(file, "basis hash table resetting     OFF\n");
+            fprintf(file, "basis hash table resetting    AUTO\n");
         } else {
             fprintf(file, "basis hash table resetting  %6d\n", st->reset_ht);
         }
@@ -288,7 +290,7 @@ void get_and_print_final_statistics(
                     (double)100*(double)st->reduce_gb_rtime
                     / (double)(st->f4_rtime));
         }
-        if (st->reset_ht != 2147483647) {
+        if (st->num_rht > 0) {
             fprintf(file, "rht          %15.2f sec %5.1f%%\n",
                     st->rht_rtime,
                     (double)100*(double)st->rht_rtime
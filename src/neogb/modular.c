@@ -68,7 +68,7 @@ void free_trace(
 {
     trace_t *tr = *trp;
     if (tr != NULL) {
-        len_t i, j;
+        len_t i;
         for (i = 0; i < tr->lts; ++i) {
             free(tr->ts[i].tri);
             free(tr->ts[i].rri);
@@ -78,9 +78,6 @@ void free_trace(
         for (i = 0; i < tr->ltd; ++i) {
             free(tr->td[i].tri);
             free(tr->td[i].rri);
-            for (j = 0; j < tr->td[i].tld/2; ++j) {
-                free(tr->td[i].rba[j]);
-            }
             free(tr->td[i].rba);
             free(tr->td[i].nlms);
         }
@@ -96,6 +93,381 @@ void free_trace(
     }
 }
 
+/* Tracer files store the F4 trace together with the exponent vectors of
+ * the basis hash table the trace refers to. They are written in native
+ * byte order and only reused for input data with the same support, this
+ * is checked via a hash of the input monomials, see trace_support_hash().
+ *
+ * Layout (version 1):
+ * magic, version, sizeof(exp_t), support hash, evl, eld,
+ * exponent vectors 1, ..., eld-1 of the basis hash table,
+ * ltd, then for each traced round deg, rld, tld, nlm, rrl, trl, rbl,
+ * rri, tri, rba, nlms, finally lml, lmps and lm. */
+#define TRACE_FILE_MAGIC    "msolvetr"
+#define TRACE_FILE_VERSION  1
+
+/* FNV-1a hash of the support of the input generators and the meta data
+ * the trace depends on, the input generators are already sorted and
+ * their monomials are the first ones in the basis hash table. */
+static uint64_t trace_support_hash(
+        const bs_t * const bs,
+        const md_t * const st
+        )
+{
+    len_t i, j;
+
+    const ht_t * const ht = bs->ht;
+    uint64_t h = 14695981039346656037ULL;
+
+#define TRACE_HASH(x) \
+    do { \
+        const uint8_t *b_ = (const uint8_t *)&(x); \
+        for (unsigned long k_ = 0; k_ < sizeof(x); ++k_) { \
+            h = (h ^ b_[k_]) * 1099511628211ULL; \
+        } \
+    } while (0)
+
+    TRACE_HASH(ht->nv);
+    TRACE_HASH(ht->evl);
+    TRACE_HASH(ht->ebl);
+    TRACE_HASH(st->ngens);
+    TRACE_HASH(st->nev);
+    TRACE_HASH(st->mo);
+    for (i = 0; i < ht->ndv * ht->bpv; ++i) {
+        TRACE_HASH(ht->dm[i]);
+    }
+    for (i = 0; i < (len_t)st->ngens; ++i) {
+        const hm_t * const row = bs->hm[i];
+        TRACE_HASH(row[LENGTH]);
+        for (j = OFFSET; j < row[LENGTH]+OFFSET; ++j) {
+            TRACE_HASH(row[j]);
+            const exp_t * const e = ht->ev[row[j]];
+            for (len_t l = 0; l < ht->evl; ++l) {
+                TRACE_HASH(e[l]);
+            }
+        }
+    }
+#undef TRACE_HASH
+    return h;
+}
+
+/* the input monomials are already in the hash table ht, all others are
+ * appended in the order they were inserted when learning the trace, ev
+ * stores the exponent vectors of the hash table entries 1, ..., eld-1 */
+static int insert_traced_monomials(
+        ht_t *ht,
+        const exp_t * const ev,
+        const hl_t eld
+        )
+{
+    hl_t i;
+
+    const len_t evl = ht->evl;
+
+    if (eld < ht->eld) {
+        return 1;
+    }
+    while (ht->esz < eld) {
+        enlarge_hash_table(ht);
+    }
+    for (i = 1; i < eld; ++i) {
+        const exp_t * const e = ev + (i-1) * evl;
+        if (i < ht->eld) {
+            if (memcmp(e, ht->ev[i], (unsigned long)evl * sizeof(exp_t)) != 0) {
+                return 1;
+            }
+        } else {
+            if (insert_in_hash_table(e, ht) != i) {
+                return 1;
+            }
+        }
+    }
+    return 0;
+}
+
+int write_trace_file(
+        const char *fn,
+        const trace_t * const tr,
+        const bs_t * const bs,
+        const md_t * const st
+        )
+{
+    len_t i;
+
+    if (tr == NULL || tr->lts > 0) {
+        return 1;
+    }
+    FILE *fh  = fopen(fn, "wb");
+    if (fh == NULL) {
+        return 1;
+    }
+    const ht_t * const ht = bs->ht;
+
+    const uint32_t version  = TRACE_FILE_VERSION;
+    const uint32_t esl      = sizeof(exp_t);
+    const uint64_t sh       = trace_support_hash(bs, st);
+    const uint64_t eld      = ht->eld;
+
+    int err = 0;
+    err |= fwrite(TRACE_FILE_MAGIC, 1, 8, fh) != 8;
+    err |= fwrite(&version, sizeof(version), 1, fh) != 1;
+    err |= fwrite(&esl, sizeof(esl), 1, fh) != 1;
+    err |= fwrite(&sh, sizeof(sh), 1, fh) != 1;
+    err |= fwrite(&(ht->evl), sizeof(len_t), 1, fh) != 1;
+    err |= fwrite(&eld, sizeof(eld), 1, fh) != 1;
+    for (i = 1; i < eld && !err; ++i) {
+        err |= fwrite(ht->ev[i], sizeof(exp_t), ht->evl, fh) != ht->evl;
+    }
+    err |= fwrite(&(tr->ltd), sizeof(len_t), 1, fh) != 1;
+    for (i = 0; i < tr->ltd && !err; ++i) {
+        const td_t * const td = tr->td + i;
+        err |= fwrite(&(td->deg), sizeof(deg_t), 1, fh) != 1;
+        err |= fwrite(&(td->rld), sizeof(len_t), 1, fh) != 1;
+        err |= fwrite(&(td->tld), sizeof(len_t), 1, fh) != 1;
+        err |= fwrite(&(td->nlm), sizeof(len_t), 1, fh) != 1;
+        err |= fwrite(&(td->rrl), sizeof(uint64_t), 1, fh) != 1;
+        err |= fwrite(&(td->trl), sizeof(uint64_t), 1, fh) != 1;
+        err |= fwrite(&(td->rbl), sizeof(uint64_t), 1, fh) != 1;
+        err |= fwrite(td->rri, 1, td->rrl, fh) != td->rrl;
+        err |= fwrite(td->tri, 1, td->trl, fh) != td->trl;
+        err |= fwrite(td->rba, 1, td->rbl, fh) != td->rbl;
+        err |= fwrite(td->nlms, sizeof(hm_t), td->nlm, fh) != td->nlm;
+    }
+    err |= fwrite(&(tr->lml), sizeof(bl_t), 1, fh) != 1;
+    err |= fwrite(tr->lmps, sizeof(bl_t), tr->lml, fh) != tr->lml;
+    err |= fwrite(tr->lm, sizeof(sdm_t), tr->lml, fh) != tr->lml;
+
+    err |= fclose(fh) != 0;
+
+    return err;
+}
+
+/* checks that at least n elements of size sz are left in the file fh
+ * of size fsz, so that sizes read from a file cannot exceed it */
+static int trace_file_holds(
+        FILE *fh,
+        const long fsz,
+        const uint64_t n,
+        const uint64_t sz
+        )
+{
+    const long pos  = ftell(fh);
+
+    return pos >= 0 && pos <= fsz && n <= (uint64_t)(fsz - pos) / sz;
+}
+
+/* reads a trace from the file fn if it was learned for input data with
+ * the same support as bs, the monomials of the stored basis hash table
+ * are inserted into bs->ht such that the trace's hash indices are valid.
+ * returns NULL if there is no such file or it does not fit the input,
+ * bs->ht is then left unchanged. */
+trace_t *read_trace_file(
+        const char *fn,
+        bs_t *bs,
+        const md_t * const st
+        )
+{
+    len_t i;
+    char magic[8];
+    uint32_t version, esl;
+    uint64_t sh, eld;
+    len_t evl, ltd;
+
+    FILE *fh  = fopen(fn, "rb");
+    if (fh == NULL) {
+        return NULL;
+    }
+    ht_t *ht    = bs->ht;
+    trace_t *tr = NULL;
+    exp_t *e    = NULL;
+    long fsz    = -1;
+    /* monomials inserted from the file are removed again on failure */
+    const hi_t oeld = ht->eld;
+
+    if (fseek(fh, 0, SEEK_END) == 0) {
+        fsz = ftell(fh);
+    }
+    if (fsz < 0 || fseek(fh, 0, SEEK_SET) != 0
+            || fread(magic, 1, 8, fh) != 8
+            || memcmp(magic, TRACE_FILE_MAGIC, 8) != 0
+            || fread(&version, sizeof(version), 1, fh) != 1
+            || version != TRACE_FILE_VERSION
+            || fread(&esl, sizeof(esl), 1, fh) != 1
+            || esl != sizeof(exp_t)
+            || fread(&sh, sizeof(sh), 1, fh) != 1
+            || sh != trace_support_hash(bs, st)
+            || fread(&evl, sizeof(evl), 1, fh) != 1
+            || evl != ht->evl
+            || fread(&eld, sizeof(eld), 1, fh) != 1
+            || eld < ht->eld || eld > (uint64_t)UINT32_MAX
+            || !trace_file_holds(fh, fsz, eld - 1,
+                (uint64_t)evl * sizeof(exp_t))) {
+        goto fail;
+    }
+    e = (exp_t *)malloc((unsigned long)(eld - 1) * evl * sizeof(exp_t) + 1);
+    if (fread(e, sizeof(exp_t), (eld - 1) * evl, fh) != (eld - 1) * evl
+            || insert_traced_monomials(ht, e, eld) != 0) {
+        goto fail;
+    }
+    tr  = initialize_trace(bs, st);
+    /* each round stores at least its header */
+    if (fread(&ltd, sizeof(ltd), 1, fh) != 1
+            || !trace_file_holds(fh, fsz, ltd,
+                sizeof(deg_t) + 3 * sizeof(len_t) + 3 * sizeof(uint64_t))) {
+        goto fail;
+    }
+    tr->std = ltd > 0 ? ltd : 1;
+    tr->td  = realloc(tr->td, (unsigned long)tr->std * sizeof(td_t));
+    memset(tr->td, 0, (unsigned long)tr->std * sizeof(td_t));
+    for (i = 0; i < ltd; ++i) {
+        td_t *td  = tr->td + i;
+        if (fread(&(td->deg), sizeof(deg_t), 1, fh) != 1
+                || fread(&(td->rld), sizeof(len_t), 1, fh) != 1
+                || fread(&(td->tld), sizeof(len_t), 1, fh) != 1
+                || fread(&(td->nlm), sizeof(len_t), 1, fh) != 1
+                || fread(&(td->rrl), sizeof(uint64_t), 1, fh) != 1
+                || fread(&(td->trl), sizeof(uint64_t), 1, fh) != 1
+                || fread(&(td->rbl), sizeof(uint64_t), 1, fh) != 1
+                || !trace_file_holds(fh, fsz, td->rrl, 1)
+                || !trace_file_holds(fh, fsz, td->trl, 1)
+                || !trace_file_holds(fh, fsz, td->rbl, 1)
+                || !trace_file_holds(fh, fsz, td->nlm, sizeof(hm_t))) {
+            goto fail;
+        }
+        tr->ltd++;
+        td->rri   = (uint8_t *)malloc(td->rrl + 1);
+        td->tri   = (uint8_t *)malloc(td->trl + 1);
+        td->rba   = (uint8_t *)malloc(td->rbl + 1);
+        td->nlms  = (hm_t *)malloc((unsigned long)(td->nlm + 1) * sizeof(hm_t));
+        if (fread(td->rri, 1, td->rrl, fh) != td->rrl
+                || fread(td->tri, 1, td->trl, fh) != td->trl
+                || fread(td->rba, 1, td->rbl, fh) != td->rbl
+                || fread(td->nlms, sizeof(hm_t), td->nlm, fh) != td->nlm) {
+            goto fail;
+        }
+    }
+    if (fread(&(tr->lml), sizeof(bl_t), 1, fh) != 1
+            || !trace_file_holds(fh, fsz, tr->lml,
+                sizeof(bl_t) + sizeof(sdm_t))) {
+        goto fail;
+    }
+    tr->lmps  = (bl_t *)malloc((unsigned long)(tr->lml + 1) * sizeof(bl_t));
+    tr->lm    = (sdm_t *)malloc((unsigned long)(tr->lml + 1) * sizeof(sdm_t));
+    if (fread(tr->lmps, sizeof(bl_t), tr->lml, fh) != tr->lml
+            || fread(tr->lm, sizeof(sdm_t), tr->lml, fh) != tr->lml) {
+        goto fail;
+    }
+    free(e);
+    fclose(fh);
+    return tr;
+
+fail:
+    free(e);
+    free_trace(&tr);
+    truncate_hash_table(ht, oeld);
+    fclose(fh);
+    return NULL;
+}
+
+static trace_t *copy_trace(
+        const trace_t * const tr,
+        const bs_t * const bs,
+        const md_t * const st
+        )
+{
+    len_t i;
+
+    trace_t *ctr  = initialize_trace(bs, st);
+
+    ctr->std  = tr->ltd > 0 ? tr->ltd : 1;
+    ctr->td   = realloc(ctr->td, (unsigned long)ctr->std * sizeof(td_t));
+    memset(ctr->td, 0, (unsigned long)ctr->std * sizeof(td_t));
+    for (i = 0; i < tr->ltd; ++i) {
+        const td_t * const td = tr->td + i;
+        td_t *ctd = ctr->td + i;
+        *ctd      = *td;
+        ctd->rri  = (uint8_t *)malloc(td->rrl + 1);
+        memcpy(ctd->rri, td->rri, td->rrl);
+        ctd->tri  = (uint8_t *)malloc(td->trl + 1);
+        memcpy(ctd->tri, td->tri, td->trl);
+        ctd->rba  = (uint8_t *)malloc(td->rbl + 1);
+        memcpy(ctd->rba, td->rba, td->rbl);
+        ctd->nlms = (hm_t *)malloc((unsigned long)(td->nlm + 1) * sizeof(hm_t));
+        memcpy(ctd->nlms, td->nlms, (unsigned long)td->nlm * sizeof(hm_t));
+    }
+    ctr->ltd  = tr->ltd;
+    ctr->lml  = tr->lml;
+    ctr->lmps = (bl_t *)malloc((unsigned long)(tr->lml + 1) * sizeof(bl_t));
+    memcpy(ctr->lmps, tr->lmps, (unsigned long)tr->lml * sizeof(bl_t));
+    ctr->lm   = (sdm_t *)malloc((unsigned long)(tr->lml + 1) * sizeof(sdm_t));
+    memcpy(ctr->lm, tr->lm, (unsigned long)tr->lml * sizeof(sdm_t));
+
+    return ctr;
+}
+
+/* stores a copy of the trace tr learned for the input data bs,
+ * replacing any trace cached before */
+void cache_trace(
+        tc_t *tc,
+        const trace_t * const tr,
+        const bs_t * const bs,
+        const md_t * const st
+        )
+{
+    hl_t i;
+
+    const ht_t * const ht = bs->ht;
+
+    if (tr == NULL || tr->lts > 0) {
+        return;
+    }
+    free_trace(&(tc->tr));
+    tc->tr  = copy_trace(tr, bs, st);
+    tc->sh  = trace_support_hash(bs, st);
+    tc->eld = ht->eld;
+    tc->ev  = realloc(tc->ev,
+            (unsigned long)(ht->eld - 1) * ht->evl * sizeof(exp_t) + 1);
+    for (i = 1; i < ht->eld; ++i) {
+        memcpy(tc->ev + (i-1) * ht->evl, ht->ev[i],
+                (unsigned long)ht->evl * sizeof(exp_t));
+    }
+}
+
+/* returns a copy of the cached trace if it was learned for input data
+ * with the same support as bs, the corresponding monomials are inserted
+ * into bs->ht, see read_trace_file(). otherwise NULL is returned. */
+trace_t *trace_from_cache(
+        const tc_t * const tc,
+        bs_t *bs,
+        const md_t * const st
+        )
+{
+    const hi_t oeld = bs->ht->eld;
+
+    if (tc->tr == NULL || tc->sh != trace_support_hash(bs, st)) {
+        return NULL;
+    }
+    if (insert_traced_monomials(bs->ht, tc->ev, tc->eld) != 0) {
+        truncate_hash_table(bs->ht, oeld);
+        return NULL;
+    }
+    return copy_trace(tc->tr, bs, st);
+}
+
+void free_trace_cache(
+        tc_t **tcp
+        )
+{
+    tc_t *tc  = *tcp;
+    if (tc != NULL) {
+        free_trace(&(tc->tr));
+        free(tc->ev);
+        free(tc);
+        tc    = NULL;
+        *tcp  = tc;
+    }
+}
+
 void free_lucky_primes(
         primes_t **lpp
         )
@@ -205,9 +577,15 @@ bs_t *f4_trace_application_phase(
         const bs_t * const ggb,       /* global basis */
         ht_t *lbht,                   /* local basis hash table, not shared */
         md_t *gst,                  /* global statistics */
-        const uint32_t fc             /* characteristic of field */
+        const uint64_t fc             /* characteristic of field */
         )
 {
+    /* the tracer kernels only handle coefficients of at most 32 bits */
+    if (fc >= ((uint64_t)1 << 32)) {
+        fprintf(stderr, "The F4 tracer does not support primes of more than 32 bits.\n");
+        return NULL;
+    }
+
     /* timings */
     double ct0, ct1, rt0, rt1;
     double rrt0, rrt1; /* for one round only */
@@ -243,8 +621,8 @@ bs_t *f4_trace_application_phase(
     bs->ld  = st->ngens;
 
     if(st->info_level>1){
-      printf("Application phase with prime p = %d, overall there are %u rounds\n",
-             fc, trace->ltd);
+      printf("Application phase with prime p = %lu, overall there are %u rounds\n",
+             (unsigned long)fc, trace->ltd);
     }
     /* let's start the f4 rounds,  we are done when no more spairs
      * are left in the pairset */
@@ -387,9 +765,15 @@ bs_t *f4sat_trace_application_test_phase(
         const bs_t * const gsat,      /* global saturation element */
         ht_t *lbht,                   /* local basis hash table, not shared */
         md_t *gst,                  /* global statistics */
-        const uint32_t fc             /* characteristic of field */
+        const uint64_t fc             /* characteristic of field */
         )
 {
+    /* the tracer kernels only handle coefficients of at most 32 bits */
+    if (fc >= ((uint64_t)1 << 32)) {
+        fprintf(stderr, "The F4 tracer does not support primes of more than 32 bits.\n");
+        return NULL;
+    }
+
     /* timings */
     double ct0, ct1, rt0, rt1;
     double rrt0, rrt1; /* for one round only */
@@ -441,8 +825,8 @@ bs_t *f4sat_trace_application_test_phase(
     update_basis_f4(ps, bs, bht, st, st->ngens);
 
     if(st->info_level>1){
-        printf("Application phase with prime p = %d, overall there are %u rounds\n",
-                fc, trace->ltd);
+        printf("Application phase with prime p = %lu, overall there are %u rounds\n",
+                (unsigned long)fc, trace->ltd);
     }
     /* let's start the f4 rounds,  we are done when no more spairs
      * are left in the pairset */
@@ -673,7 +1057,7 @@ bs_t *f4sat_trace_application_phase(
         const bs_t * const gsat,      /* global saturation element */
         ht_t *lbht,                   /* local basis hash table, not shared */
         md_t *gst,                  /* global statistics */
-        const uint32_t fc             /* characteristic of field */
+        const uint64_t fc             /* characteristic of field */
         )
 {
     /* timings */
@@ -731,8 +1115,8 @@ bs_t *f4sat_trace_application_phase(
     update_lm(bs, bht, st);
 
     if(st->info_level>1){
-        printf("Application phase with prime p = %d\n%u f4 rounds and %u saturation rounds\n",
-                fc, trace->ltd, trace->rld);
+        printf("Application phase with prime p = %lu\n%u f4 rounds and %u saturation rounds\n",
+                (unsigned long)fc, trace->ltd, trace->rld);
     }
     /* let's start the f4 rounds,  we are done when no more spairs
      * are left in the pairset */
@@ -968,9 +1352,15 @@ bs_t *f4_trace_learning_phase(
         ht_t *gbht,               /* global basis hash table, generated
                                    * in this run, used in upcoming runs */
         md_t *gst,              /* global statistics */
-        const int32_t fc          /* characteristic of field */
+        const uint64_t fc         /* characteristic of field */
         )
 {
+    /* the tracer kernels only handle coefficients of at most 32 bits */
+    if (fc >= ((uint64_t)1 << 32)) {
+        fprintf(stderr, "The F4 tracer does not support primes of more than 32 bits.\n");
+        return NULL;
+    }
+
     /* timings */
     double ct0, ct1, rt0, rt1;
     double rrt0, rrt1; /* for one round only */
@@ -1011,7 +1401,7 @@ bs_t *f4_trace_learning_phase(
     /* let's start the f4 rounds,  we are done when no more spairs
      * are left in the pairset */
     if (st->info_level > 1) {
-      printf("Learning phase with prime p = %d\n", fc);
+      printf("Learning phase with prime p = %lu\n", (unsigned long)fc);
         printf("\ndeg     sel   pairs        mat          density \
           new data             time(rd)\n");
         printf("-------------------------------------------------\
@@ -1152,9 +1542,15 @@ bs_t *f4sat_trace_learning_phase_1(
         ht_t **gbhtp,             /* global basis hash table, generated
                                    * in this run, used in upcoming runs */
         md_t *gst,              /* global statistics */
-        const int32_t fc          /* characteristic of field */
+        const uint64_t fc         /* characteristic of field */
         )
 {
+    /* the tracer kernels only handle coefficients of at most 32 bits */
+    if (fc >= ((uint64_t)1 << 32)) {
+        fprintf(stderr, "The F4 tracer does not support primes of more than 32 bits.\n");
+        return NULL;
+    }
+
     /* timings */
     double ct = cputime();
     double rt = realtime();
@@ -1479,7 +1875,7 @@ bs_t *f4sat_trace_learning_phase_2(
         ht_t **gbhtp,             /* global basis hash table, generated
                                    * in this run, used in upcoming runs */
         md_t *gst,              /* global statistics */
-        const int32_t fc          /* characteristic of field */
+        const uint64_t fc         /* characteristic of field */
         )
 {
     /* timings */
@@ -1928,7 +2324,7 @@ bs_t *modular_f4(
         const bs_t * const ggb,       /* global basis */
         ht_t * gbht,                  /* global basis hash table, shared */
         md_t *gst,                  /* global statistics */
-        const uint32_t fc             /* characteristic of field */
+        const uint64_t fc             /* characteristic of field */
         )
 {
     /* timings */
@@ -34,12 +34,42 @@ void free_trace(
         trace_t **trp
         );
 
+int write_trace_file(
+        const char *fn,
+        const trace_t * const tr,
+        const bs_t * const bs,
+        const md_t * const st
+        );
+
+trace_t *read_trace_file(
+        const char *fn,
+        bs_t *bs,
+        const md_t * const st
+        );
+
+void cache_trace(
+        tc_t *tc,
+        const trace_t * const tr,
+        const bs_t * const bs,
+        const md_t * const st
+        );
+
+trace_t *trace_from_cache(
+        const tc_t * const tc,
+        bs_t *bs,
+        const md_t * const st
+        );
+
+void free_trace_cache(
+        tc_t **tcp
+        );
+
 void free_lucky_primes(
         primes_t **lpp
         );
 
 static inline int is_lucky_prime_ui(
-                          const uint32_t prime,
+                          const uint64_t prime,
                           const bs_t * const bs
                           )
 {
@@ -100,7 +130,7 @@ static inline void generate_lucky_primes(
 
     lp->old =   lp->ld;
     lp->ld  +=  nr_new_primes;
-    lp->p   =   realloc(lp->p, (unsigned long)(lp->ld) * sizeof(uint32_t));
+    lp->p   =   realloc(lp->p, (unsigned long)(lp->ld) * sizeof(uint64_t));
 
     mpz_t last_prime;
     mpz_init(last_prime);
@@ -114,7 +144,7 @@ static inline void generate_lucky_primes(
     i = lp->old;
     while (i < lp->ld) {
         if (is_lucky_prime(last_prime, bs) == 0) {
-            lp->p[i++] = (int32_t)mpz_get_ui(last_prime);
+            lp->p[i++] = (uint64_t)mpz_get_ui(last_prime);
         }
         mpz_nextprime(last_prime, last_prime);
     }
@@ -128,7 +158,7 @@ bs_t *f4_trace_learning_phase(
         ht_t *gbht,               /* global basis hash table, generated
                                    * in this run, used in upcoming runs */
         md_t *gst,              /* global statistics */
-        const int32_t fc          /* characteristic of field */
+        const uint64_t fc         /* characteristic of field */
         );
 
 bs_t *f4sat_trace_learning_phase_1(
@@ -139,7 +169,7 @@ bs_t *f4sat_trace_learning_phase_1(
         ht_t **gbhtp,               /* global basis hash table, generated
                                    * in this run, used in upcoming runs */
         md_t *gst,              /* global statistics */
-        const int32_t fc          /* characteristic of field */
+        const uint64_t fc         /* characteristic of field */
         );
 
 bs_t *f4sat_trace_learning_phase_2(
@@ -150,7 +180,7 @@ bs_t *f4sat_trace_learning_phase_2(
         ht_t **gbhtp,               /* global basis hash table, generated
                                    * in this run, used in upcoming runs */
         md_t *gst,              /* global statistics */
-        const int32_t fc          /* characteristic of field */
+        const uint64_t fc         /* characteristic of field */
         );
 
 bs_t *f4_trace_application_phase(
@@ -159,7 +189,7 @@ bs_t *f4_trace_application_phase(
         const bs_t * const ggb,       /* global basis */
         ht_t *lbht,                   /* local basis hash table, not shared */
         md_t *gst,                  /* global statistics */
-        const uint32_t fc             /* characteristic of field */
+        const uint64_t fc             /* characteristic of field */
         );
 
 bs_t *f4sat_trace_application_phase(
@@ -169,7 +199,7 @@ bs_t *f4sat_trace_application_phase(
         const bs_t * const gsat,      /* global saturation elements */
         ht_t *lbht,                   /* local basis hash table, not shared */
         md_t *gst,                  /* global statistics */
-        const uint32_t fc             /* characteristic of field */
+        const uint64_t fc             /* characteristic of field */
         );
 
 int64_t f4_trace_julia(
@@ -201,6 +231,6 @@ bs_t *modular_f4(
         const bs_t * const ggb,       /* global basis */
         ht_t * gbht,                  /* global basis hash table, shared */
         md_t *gst,                  /* global statistics */
-        const uint32_t fc             /* characteristic of field */
+        const uint64_t fc             /* characteristic of field */
         );
 #endif
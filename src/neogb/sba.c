@@ -570,13 +570,6 @@ static void sba_final_reduction_step(
     ht_t *ht  = *htp;
     hi_t *hcm = *hcmp;
 
-    /* prepare basis data to apply final reduction process */
-    for (len_t i = 0; i < bs->ld; ++i) {
-        bs->lm[i]   = ht->hd[bs->hm[i][SM_OFFSET]].sdm;
-        bs->lmps[i] = i;
-    }
-    bs->lml = bs->ld;
-
     ht_t *sht  = initialize_secondary_hash_table(ht, st);
     mat_t *mat = (mat_t *)calloc(1, sizeof(mat_t));
     /* note: bht will become sht, and sht will become NULL,
@@ -742,6 +735,14 @@ int core_sba_schreyer(
         printf("-------------------------------------------------\
 ----------------------------\n");
     }
+    /* basis elements are stored in F4 format, prepare the lead monomial
+     * data for the final reduction process resp. exporting the basis */
+    for (len_t i = 0; i < bs->ld; ++i) {
+        bs->lm[i]   = ht->hd[bs->hm[i][OFFSET]].sdm;
+        bs->lmps[i] = i;
+    }
+    bs->lml = bs->ld;
+
     /* fully reduce elements in basis. */
     if (st->reduce_gb == 1) {
         sba_final_reduction_step(bs, &ht, &hcm, st);
@@ -196,7 +196,7 @@ static void select_all_spairs(
 /* selection of spairs, at the moment only selection
 by minial degree of the spairs is supported
 
-NOTE: The pair list is already sorted! */
+NOTE: Only the pairs of minimal degree are sorted! */
 static int32_t select_spairs_by_minimal_degree(
         mat_t *mat,
         bs_t *bs,
@@ -222,10 +222,23 @@ static int32_t select_spairs_by_minimal_degree(
     spair_t *ps     = psl->p;
     const len_t evl = bht->evl;
 
-    /* sort pair set */
-    sort_r(ps, (unsigned long)psl->ld, sizeof(spair_t), spair_cmp, bht);
-    /* get minimal degree */
-    mdeg  = ps[0].deg;
+    /* get minimal degree and move the pairs of this degree to the front,
+     * only these pairs are sorted, the remaining ones are kept unsorted
+     * until their degree is selected */
+    deg_t dmin  = ps[0].deg;
+    for (i = 1; i < psl->ld; ++i) {
+        dmin  = ps[i].deg < dmin ? ps[i].deg : dmin;
+    }
+    npd = 0;
+    for (i = 0; i < psl->ld; ++i) {
+        if (ps[i].deg == dmin) {
+            const spair_t tmp = ps[i];
+            ps[i]     = ps[npd];
+            ps[npd++] = tmp;
+        }
+    }
+    sort_r(ps, (unsigned long)npd, sizeof(spair_t), spair_cmp, bht);
+    mdeg  = dmin;
 
     /* compute a truncated GB? Check maximal degree. */
     if (md->max_gb_degree < mdeg) {
@@ -253,14 +266,6 @@ static int32_t select_spairs_by_minimal_degree(
     }
     printf("\n");
 #endif
-    for (i = 0; i < psl->ld; ++i) {
-        if (ps[i].deg > mdeg) {
-            break;
-        }
-    }
-    npd  = i;
-    /* printf("npd %d\n", npd); */
-    /* sort_r(ps, (unsigned long)npd, sizeof(spair_t), spair_cmp, bht); */
     /* now do maximal selection if it applies */
     
     /* if we stopped due to maximal selection size we still get the following
@@ -492,8 +497,248 @@ static void select_tbr(
 }
 
 
+/* Divisor trie on the lead monomials of the basis used by
+ * find_multiplied_reducer. The exponent vectors of the lead monomials are
+ * copied and sorted lexicographically. A node of the trie is a range of
+ * these sorted vectors sharing all exponents up to level lvl, its children
+ * split the range w.r.t. the exponent at level lvl. A lookup only visits
+ * the branches whose exponents are not larger than the ones of the column
+ * monomial and whose short divmask is compatible. Each node keeps the
+ * smallest position in bs->lm of its range, children are visited in this
+ * order, so that the search prefers older elements of the basis as a linear
+ * scan over bs->lm does. */
+#define DT_LEAF_SIZE 8
+#define DT_MIN_LML 64
+
+typedef struct dt_node_t dt_node_t;
+struct dt_node_t
+{
+    len_t lo;   /* first lead monomial of the range */
+    len_t hi;   /* end of the range */
+    len_t fc;   /* first child */
+    len_t nc;   /* number of children, 0 for leaves */
+    len_t lvl;  /* first level the exponents of the range differ */
+    len_t min;  /* smallest position in bs->lm of the range */
+    sdm_t sdm;  /* bits of the short divmask common to the range */
+};
+
+typedef struct dt_t dt_t;
+struct dt_t
+{
+    exp_t *ev;      /* sorted exponent vectors */
+    sdm_t *sdm;     /* their short divmasks */
+    len_t *pos;     /* their positions in bs->lm */
+    dt_node_t *nd;  /* nodes, root is nd[0] */
+    len_t nn;       /* number of nodes */
+    len_t evl;
+};
+
+static int dt_exp_cmp(
+        const void *a,
+        const void *b,
+        void *arg
+        )
+{
+    const dt_t *dt  = (dt_t *)arg;
+    const exp_t *ea = dt->ev + (unsigned long)(*((len_t *)a)) * dt->evl;
+    const exp_t *eb = dt->ev + (unsigned long)(*((len_t *)b)) * dt->evl;
+    len_t k;
+
+    for (k = 0; k < dt->evl; ++k) {
+        if (ea[k] != eb[k]) {
+            return ea[k] < eb[k] ? -1 : 1;
+        }
+    }
+    return 0;
+}
+
+static int dt_node_cmp(
+        const void *a,
+        const void *b
+        )
+{
+    const len_t ma  = ((dt_node_t *)a)->min;
+    const len_t mb  = ((dt_node_t *)b)->min;
+
+    return (ma > mb) - (ma < mb);
+}
+
+static void dt_build_node(
+        dt_t *dt,
+        const len_t n
+        )
+{
+    len_t j, k;
+
+    const len_t evl = dt->evl;
+    const len_t lo  = dt->nd[n].lo;
+    const len_t hi  = dt->nd[n].hi;
+    const exp_t *el = dt->ev + (unsigned long)lo * evl;
+    const exp_t *eh = dt->ev + (unsigned long)(hi-1) * evl;
+
+    /* ranges are sorted, so the first and last vectors give the level */
+    k = 0;
+    while (k < evl && el[k] == eh[k]) {
+        k++;
+    }
+    dt->nd[n].lvl = k;
+    dt->nd[n].fc  = 0;
+    dt->nd[n].nc  = 0;
+    dt->nd[n].min = dt->pos[lo];
+    dt->nd[n].sdm = dt->sdm[lo];
+    for (j = lo+1; j < hi; ++j) {
+        dt->nd[n].min = dt->pos[j] < dt->nd[n].min ?
+            dt->pos[j] : dt->nd[n].min;
+        dt->nd[n].sdm &=  dt->sdm[j];
+    }
+    if (hi - lo <= DT_LEAF_SIZE || k == evl) {
+        return;
+    }
+    /* children are stored contiguously */
+    const len_t fc = dt->nn;
+    j = lo;
+    while (j < hi) {
+        const exp_t key = dt->ev[(unsigned long)j * evl + k];
+        dt->nd[dt->nn].lo = j;
+        while (j < hi && dt->ev[(unsigned long)j * evl + k] == key) {
+            j++;
+        }
+        dt->nd[dt->nn].hi = j;
+        dt->nn++;
+    }
+    dt->nd[n].fc  = fc;
+    dt->nd[n].nc  = dt->nn - fc;
+    for (j = fc; j < fc + dt->nd[n].nc; ++j) {
+        dt_build_node(dt, j);
+    }
+    /* visiting children by increasing smallest position first gives
+     * the best pruning during lookups */
+    qsort(dt->nd + fc, (unsigned long)dt->nd[n].nc, sizeof(dt_node_t),
+            dt_node_cmp);
+}
+
+static dt_t *initialize_divisor_trie(
+        const bs_t * const bs
+        )
+{
+    len_t i, k;
+
+    const ht_t * const bht = bs->ht;
+    const len_t lml = bs->lml;
+    const len_t evl = bht->evl;
+
+    dt_t *dt  = (dt_t *)calloc(1, sizeof(dt_t));
+    dt->evl   = evl;
+    dt->ev    = (exp_t *)malloc((unsigned long)lml * evl * sizeof(exp_t));
+    dt->sdm   = (sdm_t *)malloc((unsigned long)lml * sizeof(sdm_t));
+    dt->pos   = (len_t *)malloc((unsigned long)lml * sizeof(len_t));
+    for (i = 0; i < lml; ++i) {
+        memcpy(dt->ev + (unsigned long)i * evl,
+                bht->ev[bs->hm[bs->lmps[i]][OFFSET]],
+                (unsigned long)evl * sizeof(exp_t));
+        dt->pos[i] = i;
+    }
+    sort_r(dt->pos, (unsigned long)lml, sizeof(len_t), dt_exp_cmp, dt);
+
+    /* apply the permutation to the exponent vectors */
+    exp_t *ev = (exp_t *)malloc((unsigned long)lml * evl * sizeof(exp_t));
+    for (i = 0; i < lml; ++i) {
+        memcpy(ev + (unsigned long)i * evl,
+                dt->ev + (unsigned long)dt->pos[i] * evl,
+                (unsigned long)evl * sizeof(exp_t));
+        dt->sdm[i] = bs->lm[dt->pos[i]];
+    }
+    free(dt->ev);
+    dt->ev  = ev;
+
+    /* each inner node has at least two children */
+    dt->nd  = (dt_node_t *)malloc(2 * (unsigned long)lml * sizeof(dt_node_t));
+    dt->nd[0].lo  = 0;
+    dt->nd[0].hi  = lml;
+    dt->nn  = 1;
+    dt_build_node(dt, 0);
+    k = dt->nn;
+    dt->nd  = realloc(dt->nd, (unsigned long)k * sizeof(dt_node_t));
+
+    return dt;
+}
+
+static void free_divisor_trie(
+        dt_t **dtp
+        )
+{
+    dt_t *dt  = *dtp;
+    if (dt != NULL) {
+        free(dt->ev);
+        free(dt->sdm);
+        free(dt->pos);
+        free(dt->nd);
+        free(dt);
+    }
+    *dtp  = NULL;
+}
+
+/* returns the position in bs->lm of a lead monomial dividing e which is
+ * smaller than best, otherwise best; levels below from are already checked
+ * for the range of node n. The search stops at the first divisor found, this
+ * is not necessarily the one of smallest position. */
+static len_t dt_find_divisor(
+        const dt_t * const dt,
+        const len_t n,
+        const len_t from,
+        const exp_t * const e,
+        const sdm_t ns,
+        len_t best
+        )
+{
+    len_t j, k;
+
+    const dt_node_t * const nd  = dt->nd + n;
+    const len_t evl = dt->evl;
+
+    if (nd->min >= best || (nd->sdm & ns)) {
+        return best;
+    }
+    const exp_t * const f = dt->ev + (unsigned long)nd->lo * evl;
+    for (k = from; k < nd->lvl; ++k) {
+        if (f[k] > e[k]) {
+            return best;
+        }
+    }
+    if (nd->nc == 0) {
+        for (j = nd->lo; j < nd->hi; ++j) {
+            if (dt->pos[j] >= best || (dt->sdm[j] & ns)) {
+                continue;
+            }
+            const exp_t * const g = dt->ev + (unsigned long)j * evl;
+            for (k = nd->lvl; k < evl; ++k) {
+                if (g[k] > e[k]) {
+                    break;
+                }
+            }
+            if (k == evl) {
+                return dt->pos[j];
+            }
+        }
+        return best;
+    }
+    for (j = nd->fc; j < nd->fc + nd->nc; ++j) {
+        if (dt->nd[j].min >= best) {
+            break;
+        }
+        if (dt->ev[(unsigned long)dt->nd[j].lo * evl + nd->lvl] <= e[nd->lvl]) {
+            const len_t r = dt_find_divisor(dt, j, nd->lvl + 1, e, ns, best);
+            if (r < best) {
+                return r;
+            }
+        }
+    }
+    return best;
+}
+
 static inline void find_multiplied_reducer(
         bs_t *bs,
+        const dt_t * const dt,
         const hm_t m,
         len_t *nr,
         hm_t **rows,
@@ -523,18 +768,27 @@ static inline void find_multiplied_reducer(
     exp_t * const * const evb = bht->ev;
 
     i = 0;
+    if (dt != NULL) {
+        i = dt_find_divisor(dt, 0, 0, e, ns, lml);
+    } else {
 start:
-    while (i < lml && lms[i] & ns) {
-        i++;
+        while (i < lml && lms[i] & ns) {
+            i++;
+        }
+        if (i < lml) {
+            const exp_t * const f = evb[bs->hm[lmps[i]][OFFSET]];
+            for (k=0; k < evl; ++k) {
+                if (e[k] < f[k]) {
+                    i++;
+                    goto start;
+                }
+            }
+        }
     }
     if (i < lml) {
         const hm_t *b = bs->hm[lmps[i]];
         const exp_t * const f = evb[b[OFFSET]];
         for (k=0; k < evl; ++k) {
-            if (e[k] < f[k]) {
-                i++;
-                goto start;
-            }
             etmp[k] = (exp_t)(e[k]-f[k]);
         }
 
@@ -591,11 +845,17 @@ static void symbolic_preprocessing(
         mat->sz *=  2;
         mat->rr =   realloc(mat->rr, (unsigned long)mat->sz * sizeof(hm_t *));
     }
+    /* the lead monomials do not change during symbolic preprocessing,
+     * for small bases a linear scan is cheaper than the trie */
+    dt_t *dt  = NULL;
+    if (bs->lml >= DT_MIN_LML) {
+        dt  = initialize_divisor_trie(bs);
+    }
     for (; i < oesld; ++i) {
         if (!sht->hd[i].idx) {
             sht->hd[i].idx = 1;
             mat->nc++;
-            find_multiplied_reducer(bs, i, &nrr, mat->rr, sht, md);
+            find_multiplied_reducer(bs, dt, i, &nrr, mat->rr, sht, md);
         }
     }
     for (; i < sht->eld; ++i) {
@@ -605,8 +865,9 @@ static void symbolic_preprocessing(
         }
         sht->hd[i].idx = 1;
         mat->nc++;
-        find_multiplied_reducer(bs, i, &nrr, mat->rr, sht, md);
+        find_multiplied_reducer(bs, dt, i, &nrr, mat->rr, sht, md);
     }
+    free_divisor_trie(&dt);
     /* realloc to real size */
     mat->rr   =   realloc(mat->rr, (unsigned long)nrr * sizeof(hm_t *));
     mat->nr   +=  nrr - onrr;
@@ -644,10 +905,11 @@ static void generate_matrix_from_trace(
     ct = cputime();
     rt = realtime();
 
-    len_t i, nr;
+    len_t nr;
     hm_t *b;
     exp_t *emul;
     hi_t h;
+    const uint8_t *p, *q;
 
     const len_t idx = md->trace_rd;
 
@@ -659,16 +921,22 @@ static void generate_matrix_from_trace(
     hm_t **rrows  = mat->rr;
     mat->tr       = (hm_t **)malloc((unsigned long)td.tld * sizeof(hm_t *));
     hm_t **trows  = mat->tr;
-    mat->rba      = (rba_t **)malloc((unsigned long)td.tld * sizeof(rba_t *));
+    mat->rbal     = td.tld/2;
+    mat->rba      = (rba_t **)malloc((unsigned long)mat->rbal * sizeof(rba_t *));
     rba_t **rba   = mat->rba;
 
+    /* row information and rbas are stored compressed in the trace,
+     * see construct_trace() */
+    len_t prev[2] = {0, 0};
+
     /* reducer rows, i.e. AB part */
-    i   = 0;
+    p   = td.rri;
     nr  = 0;
-    while (i < td.rld) {
-        b     = bs->hm[td.rri[i++]];
-        emul  = bht->ev[td.rri[i]];
-        h     = bht->hd[td.rri[i++]].val;
+    while (nr < td.rld/2) {
+        p     = next_trace_row(p, prev);
+        b     = bs->hm[prev[0]];
+        emul  = bht->ev[prev[1]];
+        h     = bht->hd[prev[1]].val;
 
 
         rrows[nr] = multiplied_poly_to_matrix_row(sht, bht, h, emul, b);
@@ -677,16 +945,20 @@ static void generate_matrix_from_trace(
 
     }
     /* to be reduced rows, i.e. CD part */
-    i   = 0;
-    nr  = 0;
-    while (i < td.tld) {
-        b     = bs->hm[td.tri[i++]];
-        emul  = bht->ev[td.tri[i]];
-        h     = bht->hd[td.tri[i]].val;
+    const unsigned long nlrba = td.rld / 2 / 32 + (((td.rld / 2) % 32) != 0);
+
+    p       = td.tri;
+    q       = td.rba;
+    prev[0] = prev[1] = 0;
+    nr      = 0;
+    while (nr < td.tld/2) {
+        p     = next_trace_row(p, prev);
+        b     = bs->hm[prev[0]];
+        emul  = bht->ev[prev[1]];
+        h     = bht->hd[prev[1]].val;
         trows[nr] = multiplied_poly_to_matrix_row(sht, bht, h, emul, b);
-        /* At the moment rba is unused */
-        rba[nr]   = td.rba[i/2];
-        i++;
+        rba[nr]   = (rba_t *)calloc(nlrba, sizeof(rba_t));
+        q         = next_trace_rba(q, rba[nr], nlrba);
         nr++;
     }
     /* meta data for matrix */
@@ -38,12 +38,128 @@ double realtime(void)
 	return (1. + (double)t.tv_usec + ((double)t.tv_sec*1000000.)) / 1000000.;
 }
 
+/* The trace is kept in memory for the whole modular computation, so
+ * the row information is stored as zigzag encoded deltas in varint
+ * format: consecutive rows mostly share the basis element and have
+ * nearby multipliers, thus most entries fit into a single byte. */
+static inline uint8_t *write_varint(
+        uint8_t *p,
+        uint64_t v
+        )
+{
+    while (v >= 0x80) {
+        *p++  = (uint8_t)(v | 0x80);
+        v >>= 7;
+    }
+    *p++  = (uint8_t)v;
+    return p;
+}
+
+static inline const uint8_t *read_varint(
+        const uint8_t *p,
+        uint64_t *v
+        )
+{
+    uint64_t r  = 0;
+    int sh      = 0;
+    while (*p & 0x80) {
+        r   |=  (uint64_t)(*p++ & 0x7F) << sh;
+        sh  +=  7;
+    }
+    *v  = r | ((uint64_t)*p++ << sh);
+    return p;
+}
+
+static inline uint64_t zigzag_delta(
+        const len_t cur,
+        const len_t prev
+        )
+{
+    const int64_t d = (int64_t)cur - (int64_t)prev;
+    return ((uint64_t)d << 1) ^ (uint64_t)(d >> 63);
+}
+
+static inline len_t undo_zigzag_delta(
+        const uint64_t v,
+        const len_t prev
+        )
+{
+    const int64_t d = (int64_t)(v >> 1) ^ -(int64_t)(v & 1);
+    return (len_t)((int64_t)prev + d);
+}
+
+/* compresses the row information pairs (basis index, multiplier)
+ * rows[0..ld), each entry is stored as delta to the corresponding
+ * entry of the previous pair, returns the number of bytes used */
+static uint64_t compress_trace_rows(
+        uint8_t **out,
+        const len_t * const rows,
+        const len_t ld
+        )
+{
+    len_t i;
+    len_t prev[2] = {0, 0};
+
+    /* a delta of two 32 bit values needs at most 5 bytes */
+    uint8_t *c  = (uint8_t *)malloc((unsigned long)ld * 5 + 1);
+    uint8_t *p  = c;
+    for (i = 0; i < ld; ++i) {
+        p         = write_varint(p, zigzag_delta(rows[i], prev[i & 1]));
+        prev[i&1] = rows[i];
+    }
+    const uint64_t len = (uint64_t)(p - c);
+    *out  = realloc(c, (unsigned long)len + 1);
+    return len;
+}
+
+/* returns the pointer to the next row information pair
+ * (basis index, multiplier) in the compressed stream p */
+static inline const uint8_t *next_trace_row(
+        const uint8_t *p,
+        len_t *prev
+        )
+{
+    uint64_t v;
+    p       = read_varint(p, &v);
+    prev[0] = undo_zigzag_delta(v, prev[0]);
+    p       = read_varint(p, &v);
+    prev[1] = undo_zigzag_delta(v, prev[1]);
+    return p;
+}
+
+/* decodes the reducers of the next to be reduced row in the
+ * compressed stream p into the (zeroed) binary array rba of
+ * nlrba entries. Each row starts with a header storing the
+ * number of reducers and whether a gap list or the binary array
+ * itself follows. */
+static inline const uint8_t *next_trace_rba(
+        const uint8_t *p,
+        rba_t *rba,
+        const unsigned long nlrba
+        )
+{
+    uint64_t h, g, k;
+    p = read_varint(p, &h);
+    if (h & 1) {
+        memcpy(rba, p, nlrba * sizeof(rba_t));
+        return p + nlrba * sizeof(rba_t);
+    }
+    uint64_t idx  = 0;
+    for (k = 0; k < (h >> 1); ++k) {
+        p   =   read_varint(p, &g);
+        idx +=  g;
+        rba[idx/32] |=  1U << (idx%32);
+        idx++;
+    }
+    return p;
+}
+
 static void construct_trace(
         trace_t *trace,
         mat_t *mat
         )
 {
-    len_t i, j;
+    len_t i, j, k;
     len_t ctr = 0;
 
     const len_t ld  = trace->ltd;
@@ -89,17 +205,20 @@ static void construct_trace(
     const len_t ntr = ctr;
 
     /* construct rows to be reduced */
-    trace->td[ld].tri  = realloc(trace->td[ld].tri,
-            (unsigned long)ntr * 2 * sizeof(len_t));
-    trace->td[ld].tld = 2 * ntr;
+    len_t *rows = (len_t *)malloc(
+            (unsigned long)(ntr > nru ? ntr : nru) * 2 * sizeof(len_t));
 
     ctr = 0;
     for (i = 0; i < nrl; ++i) {
         if (mat->tr[i] != NULL) {
-            trace->td[ld].tri[ctr++]  = mat->tr[i][BINDEX];
-            trace->td[ld].tri[ctr++]  = mat->tr[i][MULT];
+            rows[ctr++]  = mat->tr[i][BINDEX];
+            rows[ctr++]  = mat->tr[i][MULT];
         }
     }
+    free(trace->td[ld].tri);
+    trace->td[ld].trl = compress_trace_rows(&(trace->td[ld].tri), rows, ctr);
+    trace->td[ld].tld = 2 * ntr;
+
     /* get all needed reducers */
     for (i = 0; i < ntr; ++i) {
         for (j = 0; j < lrba; ++j) {
@@ -107,20 +226,20 @@ static void construct_trace(
         }
     }
 
-    /* construct rows to reduce with */
-    trace->td[ld].rri  = realloc(trace->td[ld].rri,
-            (unsigned long)nru * 2 * sizeof(len_t));
-    trace->td[ld].rld = 2 * nru;
+    /* construct rows to reduce with, ri stores the new
+     * position of the reducers, useless reducers removed */
+    len_t *ri = (len_t *)malloc((unsigned long)nru * sizeof(len_t));
 
     ctr = 0;
     for (i = 0; i < nru; ++i) {
         if (reds[i/32] >> (i%32) & 1U) {
-            trace->td[ld].rri[ctr++]  = mat->rr[i][BINDEX];
-            trace->td[ld].rri[ctr++]  = mat->rr[i][MULT];
+            ri[i]        = ctr/2;
+            rows[ctr++]  = mat->rr[i][BINDEX];
+            rows[ctr++]  = mat->rr[i][MULT];
         }
     }
-    trace->td[ld].rri = realloc(trace->td[ld].rri,
-            (unsigned long)ctr * sizeof(len_t));
+    free(trace->td[ld].rri);
+    trace->td[ld].rrl = compress_trace_rows(&(trace->td[ld].rri), rows, ctr);
     trace->td[ld].rld = ctr;
     const len_t nrr   = ctr;
 
@@ -129,25 +248,60 @@ static void construct_trace(
      * multipliers in rba */
     const unsigned long nlrba = nrr / 2 / 32 + (((nrr / 2) % 32) != 0);
 
-    /* construct rba information */
-    trace->td[ld].rba = realloc(trace->td[ld].rba,
-            (unsigned long)ntr * sizeof(rba_t *));
-    /* allocate memory     */
-    for (i = 0; i < ntr; ++i) {
-        trace->td[ld].rba[i]  = calloc(nlrba, sizeof(rba_t));
-    }
-
-    ctr = 0;
-    /* write new rbas for tracer with useless reducers removed */
-    for (i = 0; i < nru; ++i) {
-        if (reds[i/32] >> (i%32) & 1U) {
-            for (j = 0; j < ntr; ++j) {
-                trace->td[ld].rba[j][ctr/32] |=
-                    ((rba[j][i/32] >> i%32) & 1U) << ctr%32;
+    /* write new rbas for tracer with useless reducers removed:
+     * rows with only few reducers store the gaps between them,
+     * all others the binary array itself, whatever is shorter */
+    const uint64_t dl = nlrba * sizeof(rba_t);
+
+    uint64_t sz   = 64 + (uint64_t)ntr * 2;
+    uint64_t bl   = 0;
+    uint8_t *rbc  = (uint8_t *)malloc(sz);
+    uint8_t *gaps = (uint8_t *)malloc(dl + 10);
+    for (j = 0; j < ntr; ++j) {
+        uint8_t *p  = gaps;
+        uint64_t nr = 0;
+        len_t prev  = 0;
+        for (k = 0; k < lrba && (uint64_t)(p - gaps) < dl; ++k) {
+            rba_t w = rba[j][k] & reds[k];
+            while (w != 0 && (uint64_t)(p - gaps) < dl) {
+                i     =   k * 32 + (len_t)__builtin_ctz(w);
+                w     &=  w - 1;
+                p     =   write_varint(p, ri[i] - prev);
+                prev  =   ri[i] + 1;
+                nr++;
             }
-            ctr++;
+        }
+        while (bl + 10 + dl > sz) {
+            sz  *=  2;
+            rbc =   realloc(rbc, sz);
+        }
+        if ((uint64_t)(p - gaps) < dl) {
+            const uint64_t gl = (uint64_t)(p - gaps);
+            p   =   write_varint(rbc + bl, nr << 1);
+            memcpy(p, gaps, gl);
+            bl  =   (uint64_t)(p - rbc) + gl;
+        } else {
+            p   = write_varint(rbc + bl, 1);
+            rba_t *dr = (rba_t *)gaps;
+            memset(dr, 0, dl);
+            for (k = 0; k < lrba; ++k) {
+                rba_t w = rba[j][k] & reds[k];
+                while (w != 0) {
+                    i     =   k * 32 + (len_t)__builtin_ctz(w);
+                    w     &=  w - 1;
+                    dr[ri[i]/32] |= 1U << (ri[i]%32);
+                }
+            }
+            memcpy(p, dr, dl);
+            bl  =   (uint64_t)(p - rbc) + dl;
         }
     }
+    free(trace->td[ld].rba);
+    trace->td[ld].rba = realloc(rbc, bl + 1);
+    trace->td[ld].rbl = bl;
+    free(gaps);
+    free(ri);
+    free(rows);
     free(reds);
 
     trace->td[ld].deg = mat->cd;
@@ -121,4 +121,69 @@ static inline uint32_t mod_p_inverse_32(
 
     return d;
 }
+
+/* all intermediate values stay bounded by p in absolute value,
+ * so this works for primes p < 2^63 */
+static inline uint64_t mod_p_inverse_64(
+        const int64_t val,
+        const int64_t p
+        )
+{
+    int64_t a, b, c, d, e, f;
+    a =   p;
+    b =   val % p;
+    /* if b < 0 we shift correspondingly */
+    b +=  (b >> 63) & p;
+    c =   1;
+    d =   0;
+
+    while (b != 0) {
+        f = b;
+        e = a/f;
+        b = a - e*f;
+        a = f;
+        f = c;
+        c = d - e*f;
+        d = f;
+    }
+
+    /* if d < 0 we shift correspondingly */
+    d +=  (d >> 63) & p;
+
+    return (uint64_t)d;
+}
+
+/* a * b mod p for 64 bit coefficients */
+static inline uint64_t mod_p_mul_64(
+        const uint64_t a,
+        const uint64_t b,
+        const uint64_t p
+        )
+{
+    return (uint64_t)(((unsigned __int128)a * b) % p);
+}
+
+/* precomputation for Shoup's modular multiplication by the fixed
+ * multiplier b < p, i.e. floor(b * 2^64 / p) */
+static inline uint64_t mod_p_shoup_precomp_64(
+        const uint64_t b,
+        const uint64_t p
+        )
+{
+    return (uint64_t)(((unsigned __int128)b << 64) / p);
+}
+
+/* a * b mod p via Shoup's trick for a < 2^64, b < p and p < 2^63,
+ * bpre = mod_p_shoup_precomp_64(b, p) */
+static inline uint64_t mod_p_mul_shoup_64(
+        const uint64_t a,
+        const uint64_t b,
+        const uint64_t bpre,
+        const uint64_t p
+        )
+{
+    const uint64_t q  = (uint64_t)(((unsigned __int128)a * bpre) >> 64);
+    uint64_t r        = a * b - q * p;
+    return r >= p ? r - p : r;
+}
 #endif
@@ -65,6 +65,7 @@ static void insert_and_update_spairs(
         ps_t *psl,
         bs_t *bs,
         ht_t *bht,
+        int8_t *rm,
         md_t *st
         )
 {
@@ -135,51 +136,68 @@ static void insert_and_update_spairs(
     /* sort new pairs by increasing lcm, earlier polys coming first */
     sort_r(pp, (unsigned long)bl, sizeof(spair_t), spair_cmp_update, bht);
 
-    /* Gebauer-Moeller: remove real multiples of new spairs */
-    for (i = pl; i < nl; ++i) {
-        if (ps[i].deg < 0) {
+    /* Gebauer-Moeller: remove real multiples of new spairs
+     * A real divisor of an lcm is smaller w.r.t. the monomial order, thus
+     * it comes earlier in the new pairs. If a pair is removed by an earlier
+     * pair which itself gets removed, then the pair removing the latter one
+     * also removes the former one. Thus it is enough to check against the
+     * degrees before this pass which makes the checks independent from each
+     * other, we only mark pairs in rm and apply the marks afterwards. */
+#pragma omp parallel for num_threads(nthrds) \
+    private(i, j) schedule(dynamic, 64)
+    for (i = 0; i < bl; ++i) {
+        rm[i] = 0;
+        if (pp[i].deg < 0) {
             continue;
         }
-        for (j = pl; j < i; ++j) {
-            if (i == j || ps[j].deg == -1) {
+        for (j = 0; j < i; ++j) {
+            if (pp[j].deg == -1) {
                 continue;
             }
-            if (ps[i].lcm != ps[j].lcm
-                    && ps[i].deg >= ps[j].deg
-                    && check_monomial_division(ps[i].lcm, ps[j].lcm, bht)) {
-                ps[i].deg   =   -1;
+            if (pp[i].lcm != pp[j].lcm
+                    && pp[i].deg >= pp[j].deg
+                    && check_monomial_division(pp[i].lcm, pp[j].lcm, bht)) {
+                rm[i] = 1;
                 break;
             }
         }
     }
+    for (i = 0; i < bl; ++i) {
+        if (rm[i] != 0) {
+            pp[i].deg   =   -1;
+        }
+    }
 
-
-    /* Gebauer-Moeller: remove same lcm spairs from the new ones */
-    for (i = pl; i < nl; ++i) {
-        if (ps[i].deg == -1) {
-            continue;
+    /* Gebauer-Moeller: remove same lcm spairs from the new ones
+     * New pairs with the same lcm are consecutive and sorted by degree,
+     * so a pair fulfilling the product criterion comes first and removes
+     * all others, otherwise only the first pair not yet removed is kept. */
+    i = 0;
+    while (i < bl) {
+        l = i+1;
+        while (l < bl && pp[l].lcm == pp[i].lcm) {
+            l++;
         }
-        /* try to remove all others if product criterion applies */
-        if (ps[i].deg == -2) {
-            for (j = pl; j < nl; ++j) {
-                if (ps[j].lcm == ps[i].lcm) {
-                    ps[j].deg   =   -1;
-                }
+        if (pp[i].deg == -2) {
+            for (j = i; j < l; ++j) {
+                pp[j].deg   =   -1;
             }
-            /* try to eliminate this spair with earlier ones */
-        } else { 
-            for (j = i-1; j >= pl; --j) {
-                if (ps[j].deg != -1
-                        && ps[j].deg <= ps[i].deg
-                        && ps[i].lcm == ps[j].lcm) {
-                    ps[i].deg   =   -1;
-                    break;
+        } else {
+            int keep = 1;
+            for (j = i; j < l; ++j) {
+                if (pp[j].deg == -1) {
+                    continue;
+                }
+                if (keep == 1) {
+                    keep = 0;
+                } else {
+                    pp[j].deg   =   -1;
                 }
             }
         }
+        i = l;
     }
 
-
     /* remove useless pairs from pairset */
     j = 0;
     /* old pairs */
@@ -295,9 +313,13 @@ static void update_basis_f4(
     }
     check_enlarge_pairset(ps, np);
 
+    /* marks for the new pairs of each inserted element */
+    int8_t *rm  = (int8_t *)malloc(
+            (unsigned long)(bs->ld + npivs) * sizeof(int8_t));
     for (i = 0; i < npivs; ++i) {
-        insert_and_update_spairs(ps, bs, bht, st);
+        insert_and_update_spairs(ps, bs, bht, rm, st);
     }
+    free(rm);
 
     const bl_t lml          = bs->lml;
     const bl_t * const lmps = bs->lmps;
@@ -60,6 +60,9 @@ typedef struct{
   unsigned int verbose;
   unsigned int bfile;
   unsigned int classical_algo;
+  /* 0: bisection, 1: continued fractions, 2: chosen from the spread of the
+     root bounds (see CF_SPREAD_THRESHOLD) */
+  unsigned int cf_algo;
 
   unsigned int print_stats;
   int debug;
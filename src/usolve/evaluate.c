@@ -72,6 +72,123 @@ static inline void mpz_interveval_deriv_01(mpz_t *upol, unsigned long int deg,
 }
 
 
+/* floating-point numbers with an unbounded exponent: m * 2^e */
+/* with 1/2 <= |m| < 1 (or m = 0) */
+typedef struct{
+  double m;
+  long e;
+} dexp_t;
+
+/* unit roundoff used by the filter below ; mpz_get_d_2exp truncates */
+/* hence one takes 2^(-52) instead of 2^(-53) */
+#define FP_FILTER_UNIT 2.220446049250313e-16
+
+static inline void dexp_normalize(dexp_t *a){
+  int ex;
+  a->m = frexp(a->m, &ex);
+  if(a->m == 0){
+    a->e = 0;
+  }
+  else{
+    a->e += ex;
+  }
+}
+
+/* a = z * 2^sh */
+static inline void dexp_set_mpz_2exp(dexp_t *a, const mpz_t z, const long sh){
+  long ex;
+  a->m = mpz_get_d_2exp(&ex, z);
+  a->e = (a->m == 0) ? 0 : ex + sh;
+}
+
+static inline void dexp_mul(dexp_t *r, const dexp_t *a, const dexp_t *b){
+  r->m = a->m * b->m;
+  r->e = a->e + b->e;
+  dexp_normalize(r);
+}
+
+/* when exponents differ by more than 64 bits, the smallest operand is */
+/* dropped ; this costs less than one rounding error */
+static inline void dexp_add(dexp_t *r, const dexp_t *a, const dexp_t *b){
+  if(a->m == 0){
+    *r = *b;
+    return;
+  }
+  if(b->m == 0){
+    *r = *a;
+    return;
+  }
+  const long d = a->e - b->e;
+  if(d >= 64){
+    *r = *a;
+    return;
+  }
+  if(d <= -64){
+    *r = *b;
+    return;
+  }
+  if(d >= 0){
+    r->m = a->m + ldexp(b->m, -d);
+    r->e = a->e;
+  }
+  else{
+    r->m = ldexp(a->m, d) + b->m;
+    r->e = b->e;
+  }
+  dexp_normalize(r);
+}
+
+/*
+  Floating-point filter for the sign of upol(c / 2^k).
+
+  Horner's scheme is run with doubles (and unbounded exponents) on upol
+  and on |upol| at |c / 2^k|, which gives v and s. The computed value
+  satisfies |v - upol(c / 2^k)| <= gamma_{3deg+4} s (rounding of the
+  coefficients, of the point and of the 2 deg operations), so the sign
+  of v is certified when |v| is larger than twice this bound.
+
+  returns the sign of upol(c / 2^k) when it is certified, else 0
+  (hence 0 is also returned when upol(c / 2^k) = 0).
+ */
+int sgn_mpz_poly_eval_2exp_filter(mpz_t *upol, const unsigned long int deg,
+                                  mpz_t c, const long k){
+  const double g = (3.0 * deg + 4) * FP_FILTER_UNIT;
+  if(g >= 0.125){
+    return 0;
+  }
+  dexp_t x, ax, v, s, t;
+
+  dexp_set_mpz_2exp(&x, c, -k);
+  ax = x;
+  ax.m = fabs(ax.m);
+  dexp_set_mpz_2exp(&v, upol[deg], 0);
+  s = v;
+  s.m = fabs(s.m);
+
+  for(long i = deg - 1; i >= 0; i--){
+    dexp_set_mpz_2exp(&t, upol[i], 0);
+    dexp_mul(&v, &v, &x);
+    dexp_add(&v, &v, &t);
+    t.m = fabs(t.m);
+    dexp_mul(&s, &s, &ax);
+    dexp_add(&s, &s, &t);
+  }
+  if(v.m == 0){
+    return 0;
+  }
+  /* checks |v| > 4 * g * s (the bound on s itself is absorbed in the */
+  /* extra factor 2) */
+  const long d = v.e - s.e;
+  if(d < -1000){
+    return 0;
+  }
+  if(d >= 0 || ldexp(fabs(v.m), d) > 4 * g * s.m){
+    return (v.m > 0) ? 1 : -1;
+  }
+  return 0;
+}
+
+
 static inline void basic_mpz_poly_eval_at_point(mpz_t *up, unsigned long int deg,
                                                 mpz_t *c, mpz_t *val){
   mpz_set_ui(*val,0);
@@ -84,6 +201,10 @@ static inline void basic_mpz_poly_eval_at_point(mpz_t *up, unsigned long int deg
 
 
 static inline int sgn_mpz_poly_eval_at_point_naive(mpz_t *upoly, unsigned long int deg, mpz_t *c, int classical_algo){
+  int sf = sgn_mpz_poly_eval_2exp_filter(upoly, deg, *c, 0);
+  if(sf != 0){
+    return sf;
+  }
   mpz_t val;
   mpz_init(val);
   basic_mpz_poly_eval_at_point(upoly, deg, c, &val);
@@ -154,6 +275,9 @@ void mpz_poly_eval_2exp_naive2(mpz_t *upol,
 /* EValuation over an interval using a Horner scheme */
 /* assumes a and b have the same sign */
 /* returns (mpz_sgn(val_do) != mpz_sgn(val_up)); */
+/* when the floating-point filter certifies that up has a sign change */
+/* between a / 2^k and b / 2^k, the enclosure must contain 0 ; then */
+/* one returns 1 at once with val_do = -1 and val_up = 1 */
 int mpz_poly_eval_interval(mpz_t *up, const long int deg, const long k,
                            mpz_t a, mpz_t b,
                            mpz_t tmp,
@@ -168,6 +292,12 @@ int mpz_poly_eval_interval(mpz_t *up, const long int deg, const long k,
     mpz_set(val_do, up[0]);
     return 0;
   }
+  const int sa = sgn_mpz_poly_eval_2exp_filter(up, deg, a, k);
+  if(sa != 0 && sa == -sgn_mpz_poly_eval_2exp_filter(up, deg, b, k)){
+    mpz_set_si(val_do, -1);
+    mpz_set_si(val_up, 1);
+    return 1;
+  }
   mpz_set(val_up, up[deg]);
   mpz_set(val_do, up[deg]);
   mpz_t s;
@@ -483,6 +613,10 @@ static inline int sgn_mpz_poly_eval_at_point_2exp_naive(mpz_t *upol,
                                                         unsigned long int deg,
                                                         mpz_t *c, int k){
 
+  int sf = sgn_mpz_poly_eval_2exp_filter(upol, deg, *c, k);
+  if(sf != 0){
+    return sf;
+  }
   mpz_t val, coeff;
   mpz_init(coeff);
   mpz_init_set(val, upol[deg]);
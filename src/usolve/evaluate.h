@@ -51,3 +51,6 @@ void mpz_poly_eval_2exp_naive(mpz_t *, long int,
 
 int sgn_mpz_poly_eval_at_point_2exp_naive(mpz_t *, unsigned long int, mpz_t*, int);
 int sgn_mpz_poly_eval_at_point_2exp_naive2(mpz_t *, unsigned long int, mpz_t, int);
+
+int sgn_mpz_poly_eval_2exp_filter(mpz_t *, const unsigned long int,
+                                  mpz_t, const long);
@@ -25,11 +25,15 @@
 /* based on Quadratic interval refinement for real roots */
 /* J. Abott, ACM communications in computer algebra */
 
+/* when divide is 0, upol is shared with other threads and is left untouched */
 static void make_exact_root(mpz_t *upol, unsigned long int *deg,
-                            interval *rt, mpz_t *x, int k){
+                            interval *rt, mpz_t *x, int k, const int divide){
   mpz_set(rt->numer, *x);
   rt->k = k;
   rt->isexact=1;
+  if(divide == 0){
+    return;
+  }
   if(k>=0){
     USOLVEnumer_quotient(upol, deg, rt->numer, k);
   }
@@ -129,7 +133,7 @@ static void getx_and_eval_mpzidx(mpz_t *upol, unsigned long int deg,
 static int right_interval_2exp(mpz_t *upol, unsigned long int *deg_ptr,
                                interval *rt, mpz_t *x, mpz_t *b,
                                mpz_t *vala, mpz_t *valb, mpz_t *q,
-                               int k, int newk){
+                               int k, int newk, const int divide){
 
   mpz_swap(*x, *b);
   mpz_swap(*vala, *valb);
@@ -140,7 +144,7 @@ static int right_interval_2exp(mpz_t *upol, unsigned long int *deg_ptr,
   int sgnx = mpz_sgn(*vala);
 
   if(sgnb==0){
-    make_exact_root(upol, deg_ptr, rt, b, newk);
+    make_exact_root(upol, deg_ptr, rt, b, newk, divide);
     return 1;
   }
   if(sgnx!=sgnb){
@@ -154,7 +158,7 @@ static int right_interval_2exp(mpz_t *upol, unsigned long int *deg_ptr,
 static int left_interval_2exp(mpz_t *upol, unsigned long int *deg_ptr,
                                    interval *rt, mpz_t *x, mpz_t *b,
                                    mpz_t *vala, mpz_t *valb, mpz_t *q,
-                                   int k, int newk){
+                                   int k, int newk, const int divide){
 
   getx_and_eval_2expleft(upol, *deg_ptr, x, b, valb, q,
                          newk, 1);
@@ -164,7 +168,7 @@ static int left_interval_2exp(mpz_t *upol, unsigned long int *deg_ptr,
   int sgnx = mpz_sgn(*vala);
 
   if(sgnx==0){
-    make_exact_root(upol, deg_ptr, rt, x, newk);
+    make_exact_root(upol, deg_ptr, rt, x, newk, divide);
     return 1;
   }
   if(sgnx!=sgnb){
@@ -179,7 +183,8 @@ static int right_interval(mpz_t *upol, unsigned long int *deg_ptr,
                                interval *rt,
                                mpz_t *x, mpz_t *b,
                                mpz_t *vala, mpz_t *valb, mpz_t *q,
-                               int Nlog, int k, int newk){
+                               int Nlog, int k, int newk,
+                               const int divide){
 
   mpz_swap(*x, *b);
   mpz_swap(*vala, *valb);
@@ -201,7 +206,7 @@ static int right_interval(mpz_t *upol, unsigned long int *deg_ptr,
   int sgnx = mpz_sgn(*vala);
 
   if(sgnb==0){
-    make_exact_root(upol, deg_ptr, rt, b, newk);
+    make_exact_root(upol, deg_ptr, rt, b, newk, divide);
     return 1;
   }
   if(sgnx!=sgnb){
@@ -221,7 +226,8 @@ static int left_interval(mpz_t *upoly, unsigned long int *deg_ptr,
                               interval *rt,
                               mpz_t *x, mpz_t *b,
                               mpz_t *vala, mpz_t *valb,
-                              mpz_t *q, int Nlog, int k, int newk){
+                              mpz_t *q, int Nlog, int k, int newk,
+                              const int divide){
 
   if(k-Nlog>=0){
     mpz_set_ui(*b, 1);
@@ -242,7 +248,7 @@ static int left_interval(mpz_t *upoly, unsigned long int *deg_ptr,
   int sgnb = mpz_sgn(*valb);
   int sgnx = mpz_sgn(*vala);
   if(sgnx==0){
-    make_exact_root(upoly, deg_ptr, rt, x, newk);
+    make_exact_root(upoly, deg_ptr, rt, x, newk, divide);
     return 1;
   }
   if(sgnx!=sgnb){
@@ -262,7 +268,8 @@ static int left_interval(mpz_t *upoly, unsigned long int *deg_ptr,
 static void refine_root_by_N_positive_k(mpz_t *upol, unsigned long int *deg_ptr,
                                         interval *rt,
                                         mpz_t *tab, long long int Nlog,
-                                        int *success, int verbose){
+                                        int *success, int verbose,
+                                        const int divide){
   long k = (rt-> k);
   long newk = k+Nlog;
   int sgna, sgnb, sgnx;
@@ -316,7 +323,7 @@ static void refine_root_by_N_positive_k(mpz_t *upol, unsigned long int *deg_ptr,
   sgnx = mpz_sgn(*vala);
 
   if(sgnx==0){
-    make_exact_root(upol, deg_ptr, rt, x, newk);
+    make_exact_root(upol, deg_ptr, rt, x, newk, divide);
     return;
   }
 
@@ -332,7 +339,7 @@ static void refine_root_by_N_positive_k(mpz_t *upol, unsigned long int *deg_ptr,
     sgnb = mpz_sgn(*valb);
 
     if(sgnb==0){
-      make_exact_root(upol, deg_ptr, rt, b, newk);
+      make_exact_root(upol, deg_ptr, rt, b, newk, divide);
       return;
     }
     if(sgnx != sgnb){
@@ -349,7 +356,7 @@ static void refine_root_by_N_positive_k(mpz_t *upol, unsigned long int *deg_ptr,
         return;
       }
       while(right_interval_2exp(upol, deg_ptr, rt, x, b,
-                                vala, valb, q, k, newk)==0 && index <= maxindex){
+                                vala, valb, q, k, newk, divide)==0 && index <= maxindex){
         if(verbose>0){
           fprintf(stderr, "->");
         }
@@ -374,7 +381,7 @@ static void refine_root_by_N_positive_k(mpz_t *upol, unsigned long int *deg_ptr,
     sgnb = mpz_sgn(*valb);
     sgnx = mpz_sgn(*vala);
     if(sgnx==0){
-      make_exact_root(upol, deg_ptr, rt, x, newk);
+      make_exact_root(upol, deg_ptr, rt, x, newk, divide);
       return;
     }
     if(sgnx != sgnb){
@@ -391,7 +398,7 @@ static void refine_root_by_N_positive_k(mpz_t *upol, unsigned long int *deg_ptr,
         return;
       }
       while(left_interval_2exp(upol, deg_ptr, rt,
-                               x, b, vala, valb, q, k, newk) == 0){
+                               x, b, vala, valb, q, k, newk, divide) == 0){
         if(verbose>0){
           fprintf(stderr, "<-");
         }
@@ -409,7 +416,8 @@ static void refine_root_by_N_positive_k(mpz_t *upol, unsigned long int *deg_ptr,
 //tab[2] contient b
 static void refine_root_by_N_negative_k(mpz_t *upol, unsigned long int *deg_ptr,
                                         interval *rt, mpz_t *tab, long long int Nlog,
-                                        int *success, int verbose){
+                                        int *success, int verbose,
+                                        const int divide){
   long newk;
   /* one takes the opposite */
   long k = - (rt-> k);
@@ -457,7 +465,7 @@ static void refine_root_by_N_negative_k(mpz_t *upol, unsigned long int *deg_ptr,
   sgnx = mpz_sgn(*vala);
 
   if(sgnx==0){
-    make_exact_root(upol, deg_ptr, rt, x, newk);
+    make_exact_root(upol, deg_ptr, rt, x, newk, divide);
     return;
   }
 
@@ -482,7 +490,7 @@ static void refine_root_by_N_negative_k(mpz_t *upol, unsigned long int *deg_ptr,
     sgnx = mpz_sgn(*tmpvala);
 
     if(sgnb==0){
-      make_exact_root(upol, deg_ptr, rt, b, newk);
+      make_exact_root(upol, deg_ptr, rt, b, newk, divide);
       return;
     }
     if(sgnx != sgnb){
@@ -505,7 +513,7 @@ static void refine_root_by_N_negative_k(mpz_t *upol, unsigned long int *deg_ptr,
       }
 
       while(right_interval(upol, deg_ptr, rt, x, b,
-                           vala, valb, q, Nlog, k, newk) == 0){
+                           vala, valb, q, Nlog, k, newk, divide) == 0){
         if(verbose>0){
           fprintf(stderr, "|->");
         }
@@ -542,7 +550,7 @@ static void refine_root_by_N_negative_k(mpz_t *upol, unsigned long int *deg_ptr,
     sgnb = mpz_sgn(*valb);
     sgnx = mpz_sgn(*vala);
     if(sgnx==0){
-      make_exact_root(upol, deg_ptr, rt, x, newk);
+      make_exact_root(upol, deg_ptr, rt, x, newk, divide);
       return;
     }
     if(sgnx != sgnb){
@@ -563,7 +571,7 @@ static void refine_root_by_N_negative_k(mpz_t *upol, unsigned long int *deg_ptr,
         return;
       }
       while(left_interval(upol, deg_ptr, rt, x, b,
-                          vala, valb, q, Nlog, k, newk) == 0){
+                          vala, valb, q, Nlog, k, newk, divide) == 0){
         if(verbose>0){
           fprintf(stderr, "<-|");
         }
@@ -596,7 +604,7 @@ static void refine_root_by_N_negative_k(mpz_t *upol, unsigned long int *deg_ptr,
 static void refine_positive_root_by_N(mpz_t *upol, unsigned long int *deg_ptr,
                                       interval *rt, mpz_t *tab,
                                       unsigned long long int Nlog, int *success,
-                                      int verbose){
+                                      int verbose, const int divide){
   *success = 1;
 
   long k = rt-> k;
@@ -609,25 +617,28 @@ static void refine_positive_root_by_N(mpz_t *upol, unsigned long int *deg_ptr,
 
     /* interval is (rt->numer, rt->numer + 2^(-k)) */
     refine_root_by_N_negative_k(upol, deg_ptr, rt,
-                                tab, Nlog, success, verbose);
+                                tab, Nlog, success, verbose, divide);
   }
   else{
 
     /* interval is (rt->numer/2^k, rt->numer/2^k) */
     refine_root_by_N_positive_k(upol, deg_ptr, rt,
-                                tab, Nlog, success, verbose);
+                                tab, Nlog, success, verbose, divide);
   }
 }
 
-void refine_QIR_positive_root(mpz_t *upol, unsigned long int *deg_ptr,
-                              interval *rt, mpz_t *tab, int prec, int verbose){
+static void refine_QIR_positive_root_divide(mpz_t *upol,
+                                           unsigned long int *deg_ptr,
+                                           interval *rt, mpz_t *tab,
+                                           int prec, int verbose,
+                                           const int divide){
   if(rt->isexact==1) return;
   long long int Nlog = 2;
   int success = 1;
   while(rt->isexact != 1 && rt->k < prec){
 
     refine_positive_root_by_N(upol, deg_ptr, rt, tab,
-                              Nlog, &success, verbose);
+                              Nlog, &success, verbose, divide);
     if(rt->isexact==1) return;
 
     if(mpz_sgn(tab[0]) == mpz_sgn(tab[1])) {
@@ -646,6 +657,11 @@ void refine_QIR_positive_root(mpz_t *upol, unsigned long int *deg_ptr,
   }
 }
 
+void refine_QIR_positive_root(mpz_t *upol, unsigned long int *deg_ptr,
+                              interval *rt, mpz_t *tab, int prec, int verbose){
+  refine_QIR_positive_root_divide(upol, deg_ptr, rt, tab, prec, verbose, 1);
+}
+
 
 void get_values_at_bounds(mpz_t *upol, unsigned long int deg,
                           interval *rt, mpz_t *tab){
@@ -720,168 +736,200 @@ static void remove_exact_roots_by_division(mpz_t *upol, unsigned long int *deg,
 }
 
 
-/* Refinement using Newton-Interval like technique (but replacing Newton with */
-/* linear interpolation) */
-/* it takes as input a pointer to deg because it may change after performing */
-/* divisions when there are exact roots */
-void refine_QIR_roots(mpz_t *upol, unsigned long int *deg, interval *roots,
-                      int nbneg, int nbpos,
-                      int prec, int verbose, double step, int nthreads){
-  unsigned long int i;
-  /* table for intermediate values */
-  mpz_t *tab = (mpz_t *)(malloc(sizeof(mpz_t) * 8));
-  for(i=0;i<8;i++){
-    mpz_init(tab[i]);
+/* precision up to which a root is refined ; when adaptative is set, this */
+/* precision grows with the size of the root (pos_rt is non-negative) */
+static inline int QIR_target_precision(const unsigned long int deg,
+                                       interval *pos_rt, const long k,
+                                       const int prec, const int adaptative,
+                                       const long shift){
+  if(adaptative == 0){
+    return prec;
   }
+  long d = 1 + ilog2_mpz(pos_rt->numer) - k;
+  return prec + ((deg - 1) * MAX(0, shift + d)) / 32;
+}
 
-  double e_time = 0, refine_time = realtime();
-  int nb = nbneg + nbpos;
-
-  remove_exact_roots_by_division(upol, deg, roots, nb, nthreads);
-
-
-  interval *pos_rt = (interval *)(malloc(sizeof(interval)));
-  mpz_init(pos_rt->numer);
-  mpz_t newc;
-  mpz_init(newc);
-
-  for(i = 0; i <= *deg; i++){
-    if(i%2 == 1){
-      mpz_neg(upol[i], upol[i]);
+/* refines a negative root ; upol must have been replaced by upol(-x) */
+static void refine_QIR_negative_root(mpz_t *upol, unsigned long int *deg,
+                                     interval *rt, interval *pos_rt,
+                                     mpz_t *tab, mpz_t newc,
+                                     int prec, int adaptative, int verbose,
+                                     const int divide){
+  if(rt->k > 0){
+    if(rt->isexact!=1){
+      mpz_add_ui(pos_rt->numer, rt->numer, 1);
+      mpz_neg(pos_rt->numer, pos_rt->numer);
     }
+    pos_rt->k = rt->k;
+    pos_rt->sign_left = - (rt->sign_left);
+    pos_rt->isexact = rt->isexact;
   }
-
-  for(i = 0; i < nbneg; i++){
-
-    interval *rt = roots + i;
-
-    /* display_root(stderr, rt); */
-
-    if(rt->k > 0){
-      if(rt->isexact!=1){
-        mpz_add_ui(pos_rt->numer, rt->numer, 1);
-        mpz_neg(pos_rt->numer, pos_rt->numer);
-      }
-      pos_rt->k = rt->k;
-      pos_rt->sign_left = - (rt->sign_left);
-      pos_rt->isexact = rt->isexact;
-    }
-    else {
-      if(rt->isexact!=1){
-        mpz_set_ui(newc, 1);
-        mpz_mul_2exp(newc, newc, -rt->k);
-        mpz_add(pos_rt->numer, rt->numer, newc);
-        mpz_neg(pos_rt->numer, pos_rt->numer);
-      }
-      pos_rt->k = rt->k;
-      pos_rt->sign_left = - (rt->sign_left);
-      pos_rt->isexact = rt->isexact;
+  else {
+    if(rt->isexact!=1){
+      mpz_set_ui(newc, 1);
+      mpz_mul_2exp(newc, newc, -rt->k);
+      mpz_add(pos_rt->numer, rt->numer, newc);
+      mpz_neg(pos_rt->numer, pos_rt->numer);
     }
+    pos_rt->k = rt->k;
+    pos_rt->sign_left = - (rt->sign_left);
+    pos_rt->isexact = rt->isexact;
+  }
 
-    if(pos_rt->isexact==0){
-      get_values_at_bounds(upol, *deg, pos_rt, tab);
-      if(mpz_sgn(tab[0])==0 || mpz_sgn(tab[1])==0){
-        fprintf(stderr, "Error in refinement (neg. roots): these values should not be zero\n");
-        exit(1);
-      }
-      refine_QIR_positive_root(upol, deg, pos_rt, tab, prec, verbose);
+  if(pos_rt->isexact==0){
+    get_values_at_bounds(upol, *deg, pos_rt, tab);
+    if(mpz_sgn(tab[0])==0 || mpz_sgn(tab[1])==0){
+      fprintf(stderr, "Error in refinement (neg. roots): these values should not be zero\n");
+      exit(1);
+    }
+    refine_QIR_positive_root_divide(upol, deg, pos_rt, tab,
+                                    QIR_target_precision(*deg, pos_rt, rt->k,
+                                                         prec, adaptative, 0),
+                                    verbose, divide);
 
-      if(mpz_sgn(tab[0])==mpz_sgn(tab[1])){
-        fprintf(stderr, "BUG in refinement (sgn tab[0]==sgn tab[1]) for neg. roots");
-        exit(1);
-      }
+    if(mpz_sgn(tab[0])==mpz_sgn(tab[1])){
+      fprintf(stderr, "BUG in refinement (sgn tab[0]==sgn tab[1]) for neg. roots");
+      exit(1);
     }
+  }
 
-    if(pos_rt->isexact==1){
-      if(pos_rt->k < 0){
-        pos_rt->k = 0;
-      }
+  if(pos_rt->isexact==1){
+    if(pos_rt->k < 0){
+      pos_rt->k = 0;
     }
-    //We assume precision >=0
-    if(pos_rt->isexact!=1){
-      rt->k = pos_rt->k;
+  }
+  //We assume precision >=0
+  if(pos_rt->isexact!=1){
+    rt->k = pos_rt->k;
+    rt->isexact = pos_rt->isexact;
+    mpz_add_ui(rt->numer, pos_rt->numer, 1);
+    mpz_neg(rt->numer, rt->numer);
+  }
+  else{
+    rt->k = pos_rt->k;
+    if(rt->isexact!=1){
       rt->isexact = pos_rt->isexact;
-      mpz_add_ui(rt->numer, pos_rt->numer, 1);
+      mpz_set(rt->numer, pos_rt->numer);
       mpz_neg(rt->numer, rt->numer);
     }
-    else{
-      rt->k = pos_rt->k;
-      if(rt->isexact!=1){
-        rt->isexact = pos_rt->isexact;
-        mpz_set(rt->numer, pos_rt->numer);
-        mpz_neg(rt->numer, rt->numer);
-      }
-    }
+  }
+}
 
-    e_time += realtime() - refine_time;
-    if(e_time>=step){
-      refine_time = realtime();
-      e_time = 0;
-      if(verbose>=1){
-        fprintf(stderr, "{%.2f%s}", ((double)i / nb) * 100, "%");
+static void refine_QIR_nonnegative_root(mpz_t *upol, unsigned long int *deg,
+                                        interval *rt, mpz_t *tab,
+                                        int prec, int adaptative, int verbose,
+                                        const int divide){
+  if(rt->isexact==0){
+    get_values_at_bounds(upol, *deg, rt, tab);
+    if(mpz_sgn(tab[1])==0 || mpz_sgn(tab[0])==0){
+      fprintf(stderr, "Error in refinement (pos. roots): these values should not be zero\n");
+      exit(1);
+    }
+    refine_QIR_positive_root_divide(upol, deg, rt, tab,
+                                    QIR_target_precision(*deg, rt, rt->k,
+                                                         prec, adaptative, 1),
+                                    verbose, divide);
+    if(mpz_sgn(tab[0])==mpz_sgn(tab[1])){
+      fprintf(stderr,"BUG in refinement (sgn tab[0]=sgn tab[1] for pos. roots)");
+      exit(1);
+    }
+    if(rt->isexact==1){
+      if(rt->k < 0){
+        rt->k = 0;
       }
     }
   }
+}
 
-  mpz_clear(newc);
-  mpz_clear(pos_rt->numer);
-  free(pos_rt);
+typedef struct{
+  long cost;
+  unsigned long int idx;
+} root_cost_t;
 
-  /* now we refine positive roots */
-  for(i = 0; i <= *deg; i++){
-    if(i%2 == 1){
-      mpz_neg(upol[i], upol[i]);
-    }
+static int root_cost_cmp(const void *a, const void *b){
+  const root_cost_t *ra = (const root_cost_t *)a;
+  const root_cost_t *rb = (const root_cost_t *)b;
+  if(ra->cost != rb->cost){
+    return (ra->cost < rb->cost) ? 1 : -1;
   }
+  return (ra->idx > rb->idx) - (ra->idx < rb->idx);
+}
 
-  for(i=nbneg; i < nb; i++){
+/* refines in parallel roots[0], ..., roots[nb-1] which are all negative */
+/* (when neg = 1) or all non-negative (when neg = 0) */
+/* upol is shared by all threads, hence exact roots met during the */
+/* refinement are not divided out ; each thread uses its own scratch space */
+/* roots are handled by decreasing expected cost to balance the load */
+static void refine_QIR_roots_parallel(mpz_t *upol, const unsigned long int deg,
+                                      interval *roots, const unsigned long int nb,
+                                      int prec, int adaptative, int verbose,
+                                      const int nthreads, const int neg){
+  root_cost_t *order = malloc(sizeof(root_cost_t) * nb);
+  for(unsigned long int i = 0; i < nb; i++){
     interval *rt = roots + i;
-
-    if(rt->isexact==0){
-      get_values_at_bounds(upol, *deg, rt, tab);
-      if(mpz_sgn(tab[1])==0 || mpz_sgn(tab[0])==0){
-        fprintf(stderr, "Error in refinement (pos. roots): these values should not be zero\n");
-        exit(1);
-      }
-      refine_QIR_positive_root(upol, deg, rt, tab, prec, verbose);
-      if(mpz_sgn(tab[0])==mpz_sgn(tab[1])){
-        fprintf(stderr,"BUG in refinement (sgn tab[0]=sgn tab[1] for pos. roots)");
-        exit(1);
-      }
-      if(rt->isexact==1){
-        if(rt->k < 0){
-          rt->k = 0;
-        }
-      }
+    order[i].idx = i;
+    if(rt->isexact == 1){
+      order[i].cost = 0;
     }
-
-    e_time += realtime() - refine_time;
-    if(e_time>=step){
-      refine_time = realtime();
-      e_time = 0;
-      if(verbose>=1){
-        fprintf(stderr, "{%.2f%s}", ((double)(i) / nb) * 100, "%");
-      }
+    else{
+      /* for negative roots, numer is used as a proxy for the opposite root */
+      order[i].cost = QIR_target_precision(deg, rt, rt->k, prec,
+                                           adaptative, 1 - neg) - rt->k;
+      order[i].cost = MAX(order[i].cost, 1);
     }
-
   }
-  if(verbose>=1){
-    fprintf(stderr, "\n");
+  qsort(order, nb, sizeof(root_cost_t), root_cost_cmp);
+
+  mpz_t *tabs = malloc(sizeof(mpz_t) * 8 * nthreads);
+  mpz_t *newcs = malloc(sizeof(mpz_t) * nthreads);
+  interval *pos_rts = malloc(sizeof(interval) * nthreads);
+  for(int t = 0; t < nthreads; t++){
+    for(int j = 0; j < 8; j++){
+      mpz_init(tabs[8 * t + j]);
+    }
+    mpz_init(newcs[t]);
+    mpz_init(pos_rts[t].numer);
   }
-  for(i = 0; i < 8; i++){
-    mpz_clear(tab[i]);
+
+  long i;
+#pragma omp parallel for num_threads(nthreads) \
+  private(i) schedule(dynamic, 1)
+  for(i = 0; i < (long)nb; i++){
+#ifdef _OPENMP
+    const int t = omp_get_thread_num();
+#else
+    const int t = 0;
+#endif
+    unsigned long int ldeg = deg;
+    interval *rt = roots + order[i].idx;
+    if(neg){
+      refine_QIR_negative_root(upol, &ldeg, rt, pos_rts + t,
+                               tabs + 8 * t, newcs[t],
+                               prec, adaptative, verbose, 0);
+    }
+    else{
+      refine_QIR_nonnegative_root(upol, &ldeg, rt, tabs + 8 * t,
+                                  prec, adaptative, verbose, 0);
+    }
   }
-  free(tab);
+
+  for(int t = 0; t < nthreads; t++){
+    for(int j = 0; j < 8; j++){
+      mpz_clear(tabs[8 * t + j]);
+    }
+    mpz_clear(newcs[t]);
+    mpz_clear(pos_rts[t].numer);
+  }
+  free(tabs);
+  free(newcs);
+  free(pos_rts);
+  free(order);
 }
 
-/* Refinement using Newton-Interval like technique (but replacing Newton with */
-/* linear interpolation) */
-/* it takes as input a pointer to deg because it may change after performing */
-/* divisions when there are exact roots */
-/* the precision of the refinement depends on the value of the root to be defined */
-void refine_QIR_roots_adaptative(mpz_t *upol, unsigned long int *deg, interval *roots,
-                                 int nbneg, int nbpos,
-                                 int prec, int verbose, double step, int nthreads){
+static void refine_QIR_roots_generic(mpz_t *upol, unsigned long int *deg,
+                                     interval *roots, int nbneg, int nbpos,
+                                     int prec, int verbose, double step,
+                                     int nthreads, int adaptative){
   unsigned long int i;
   /* table for intermediate values */
   mpz_t *tab = (mpz_t *)(malloc(sizeof(mpz_t) * 8));
@@ -906,79 +954,25 @@ void refine_QIR_roots_adaptative(mpz_t *upol, unsigned long int *deg, interval *
     }
   }
 
-  for(i = 0; i < nbneg; i++){
-
-    interval *rt = roots + i;
-
-    /* display_root(stderr, rt); */
-
-    if(rt->k > 0){
-      if(rt->isexact!=1){
-        mpz_add_ui(pos_rt->numer, rt->numer, 1);
-        mpz_neg(pos_rt->numer, pos_rt->numer);
-      }
-      pos_rt->k = rt->k;
-      pos_rt->sign_left = - (rt->sign_left);
-      pos_rt->isexact = rt->isexact;
-    }
-    else {
-      if(rt->isexact!=1){
-        mpz_set_ui(newc, 1);
-        mpz_mul_2exp(newc, newc, -rt->k);
-        mpz_add(pos_rt->numer, rt->numer, newc);
-        mpz_neg(pos_rt->numer, pos_rt->numer);
-      }
-      pos_rt->k = rt->k;
-      pos_rt->sign_left = - (rt->sign_left);
-      pos_rt->isexact = rt->isexact;
-    }
+  if(nthreads > 1 && nbneg > 1){
+    refine_QIR_roots_parallel(upol, *deg, roots, nbneg,
+                              prec, adaptative, verbose, nthreads, 1);
+  }
+  else{
+    for(i = 0; i < nbneg; i++){
 
-    if(pos_rt->isexact==0){
-      get_values_at_bounds(upol, *deg, pos_rt, tab);
-      if(mpz_sgn(tab[0])==0 || mpz_sgn(tab[1])==0){
-        fprintf(stderr, "Error in refinement (neg. roots): these values should not be zero\n");
-        exit(1);
-      }
-      long d = 1 + ilog2_mpz(pos_rt->numer) - rt->k;
+      interval *rt = roots + i;
 
-      /* fprintf(stderr, "[%d, %ld]", prec, */
-      /*         prec + ((*deg) * MAX(0, d)) / 32); */
-      refine_QIR_positive_root(upol, deg, pos_rt, tab,
-                               prec + (((*deg)-1) * MAX(0, d)) / 32, verbose);
+      refine_QIR_negative_root(upol, deg, rt, pos_rt, tab, newc,
+                               prec, adaptative, verbose, 1);
 
-      if(mpz_sgn(tab[0])==mpz_sgn(tab[1])){
-        fprintf(stderr, "BUG in refinement (sgn tab[0]==sgn tab[1]) for neg. roots");
-        exit(1);
-      }
-    }
-
-    if(pos_rt->isexact==1){
-      if(pos_rt->k < 0){
-        pos_rt->k = 0;
-      }
-    }
-    //We assume precision >=0
-    if(pos_rt->isexact!=1){
-      rt->k = pos_rt->k;
-      rt->isexact = pos_rt->isexact;
-      mpz_add_ui(rt->numer, pos_rt->numer, 1);
-      mpz_neg(rt->numer, rt->numer);
-    }
-    else{
-      rt->k = pos_rt->k;
-      if(rt->isexact!=1){
-        rt->isexact = pos_rt->isexact;
-        mpz_set(rt->numer, pos_rt->numer);
-        mpz_neg(rt->numer, rt->numer);
-      }
-    }
-
-    e_time += realtime() - refine_time;
-    if(e_time>=step){
-      refine_time = realtime();
-      e_time = 0;
-      if(verbose>=1){
-        fprintf(stderr, "{%.2f%s}", ((double)i / nb) * 100, "%");
+      e_time += realtime() - refine_time;
+      if(e_time>=step){
+        refine_time = realtime();
+        e_time = 0;
+        if(verbose>=1){
+          fprintf(stderr, "{%.2f%s}", ((double)i / nb) * 100, "%");
+        }
       }
     }
   }
@@ -994,40 +988,27 @@ void refine_QIR_roots_adaptative(mpz_t *upol, unsigned long int *deg, interval *
     }
   }
 
-  for(i=nbneg; i < nb; i++){
-    interval *rt = roots + i;
-
-    if(rt->isexact==0){
-      get_values_at_bounds(upol, *deg, rt, tab);
-      if(mpz_sgn(tab[1])==0 || mpz_sgn(tab[0])==0){
-        fprintf(stderr, "Error in refinement (pos. roots): these values should not be zero\n");
-        exit(1);
-      }
-      long d = 1 + ilog2_mpz(rt->numer) - rt->k;
-
-      /* fprintf(stderr, "[%d, %ld]", prec, prec + ((*deg) * MAX(0, 1 + d)) / 32); */
-      refine_QIR_positive_root(upol, deg, rt, tab,
-                               prec + (((*deg) - 1) * MAX(0, 1 + d)) / 32, verbose);
-      if(mpz_sgn(tab[0])==mpz_sgn(tab[1])){
-        fprintf(stderr,"BUG in refinement (sgn tab[0]=sgn tab[1] for pos. roots)");
-        exit(1);
-      }
-      if(rt->isexact==1){
-        if(rt->k < 0){
-          rt->k = 0;
+  if(nthreads > 1 && nbpos > 1){
+    refine_QIR_roots_parallel(upol, *deg, roots + nbneg, nbpos,
+                              prec, adaptative, verbose, nthreads, 0);
+  }
+  else{
+    for(i=nbneg; i < nb; i++){
+      interval *rt = roots + i;
+
+      refine_QIR_nonnegative_root(upol, deg, rt, tab,
+                                  prec, adaptative, verbose, 1);
+
+      e_time += realtime() - refine_time;
+      if(e_time>=step){
+        refine_time = realtime();
+        e_time = 0;
+        if(verbose>=1){
+          fprintf(stderr, "{%.2f%s}", ((double)(i) / nb) * 100, "%");
         }
       }
-    }
 
-    e_time += realtime() - refine_time;
-    if(e_time>=step){
-      refine_time = realtime();
-      e_time = 0;
-      if(verbose>=1){
-        fprintf(stderr, "{%.2f%s}", ((double)(i) / nb) * 100, "%");
-      }
     }
-
   }
   if(verbose>=1){
     fprintf(stderr, "\n");
@@ -1038,6 +1019,31 @@ void refine_QIR_roots_adaptative(mpz_t *upol, unsigned long int *deg, interval *
   free(tab);
 }
 
+/* Refinement using Newton-Interval like technique (but replacing Newton with */
+/* linear interpolation) */
+/* it takes as input a pointer to deg because it may change after performing */
+/* divisions when there are exact roots */
+/* when nthreads > 1, roots are refined in parallel */
+void refine_QIR_roots(mpz_t *upol, unsigned long int *deg, interval *roots,
+                      int nbneg, int nbpos,
+                      int prec, int verbose, double step, int nthreads){
+  refine_QIR_roots_generic(upol, deg, roots, nbneg, nbpos,
+                           prec, verbose, step, nthreads, 0);
+}
+
+/* Refinement using Newton-Interval like technique (but replacing Newton with */
+/* linear interpolation) */
+/* it takes as input a pointer to deg because it may change after performing */
+/* divisions when there are exact roots */
+/* the precision of the refinement depends on the value of the root to be defined */
+/* when nthreads > 1, roots are refined in parallel */
+void refine_QIR_roots_adaptative(mpz_t *upol, unsigned long int *deg, interval *roots,
+                                 int nbneg, int nbpos,
+                                 int prec, int verbose, double step, int nthreads){
+  refine_QIR_roots_generic(upol, deg, roots, nbneg, nbpos,
+                           prec, verbose, step, nthreads, 1);
+}
+
 
 void refine_all_roots_naive(mpz_t *upol, unsigned long int deg,
                             interval *roots, unsigned long int nb,
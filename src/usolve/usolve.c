@@ -24,6 +24,7 @@
 
 #include<stdio.h>
 #include<stdlib.h>
+#include<limits.h>
 #include<gmp.h>
 #ifdef _OPENMP
 #include<omp.h>
@@ -38,6 +39,12 @@
 
 
 #define THRESHOLDSHIFT 256
+/* continued fractions are used when log2 of the ratio between the upper and
+   lower bounds on the positive (or negative) roots exceeds this value */
+#define CF_SPREAD_THRESHOLD 64
+/* in continued fraction isolation, nodes are rescaled when the lower bound
+   on their positive roots exceeds 2^CF_SCALE_THRESHOLD */
+#define CF_SCALE_THRESHOLD 2
 #define POWER_HACK 1
 
 #define ilog2(a) mpz_sizeinbase(a,2)
@@ -956,6 +963,9 @@ static void initialize_flags(usolve_flags *flags){
   flags->verbose = 0;
   flags->bfile = 0;
   flags->classical_algo = 0;
+  /* continued fractions are used for roots of very different sizes,
+     see use_continued_fractions */
+  flags->cf_algo = 2;
   flags->print_stats = 0;
   flags->debug = 0;
 }
@@ -1080,6 +1090,571 @@ static void display_stats(usolve_flags *flags){
 
 
 
+/* Continued fraction isolation (Akritas-Strzebonski) of the positive roots
+   of a square-free polynomial upol with upol[0] != 0.
+
+   A node of the search tree is a polynomial P together with the Moebius
+   transformation M(x) = (a x + b) / (c x + d) (a, b, c, d >= 0) such that M
+   maps the positive roots of P onto the roots of upol lying in
+   M((0, +infty)). Roots are first isolated in intervals with rational end
+   points which are then turned into dyadic intervals (see cf_to_dyadic). */
+
+typedef struct{
+  mpz_t *pol;
+  unsigned long int deg;
+  unsigned long int alloc;
+  mpz_t a, b, c, d;
+} cf_node;
+
+/* root isolated by continued fractions ; rd = 0 encodes +infty */
+typedef struct{
+  mpz_t ln, ld; /* left end (or exact root) ln / ld */
+  mpz_t rn, rd; /* right end rn / rd */
+  unsigned int isexact;
+} cf_root;
+
+static inline void cf_node_init(cf_node *node, mpz_t *pol,
+                                const unsigned long int deg){
+  node->pol = (mpz_t *)malloc(sizeof(mpz_t) * (deg + 1));
+  for(unsigned long int i = 0; i <= deg; i++){
+    mpz_init_set(node->pol[i], pol[i]);
+  }
+  node->deg = deg;
+  node->alloc = deg + 1;
+  mpz_init_set_ui(node->a, 1);
+  mpz_init_set_ui(node->b, 0);
+  mpz_init_set_ui(node->c, 0);
+  mpz_init_set_ui(node->d, 1);
+}
+
+static inline void cf_node_clear(cf_node *node){
+  for(unsigned long int i = 0; i < node->alloc; i++){
+    mpz_clear(node->pol[i]);
+  }
+  free(node->pol);
+  mpz_clear(node->a);
+  mpz_clear(node->b);
+  mpz_clear(node->c);
+  mpz_clear(node->d);
+}
+
+/* divides the polynomial of node by x (0 being a simple root of it) */
+static inline void cf_node_divide_by_x(cf_node *node){
+  if(mpz_sgn(node->pol[1]) == 0){
+    fprintf(stderr, "error: the polynomial is not square-free\n");
+    exit(1);
+  }
+  for(unsigned long int i = 0; i < node->deg; i++){
+    mpz_swap(node->pol[i], node->pol[i + 1]);
+  }
+  node->deg--;
+}
+
+static inline void cf_taylorshift1(mpz_t *upol, const unsigned long int deg,
+                                   usolve_flags *flags){
+  double e_time = realtime();
+  if(flags->classical_algo==1){
+    taylorshift1_naive(upol, deg);
+  }
+  else{
+    taylorshift1_dac(upol, deg,
+                     flags->tmpol, flags->shift_pwx, flags->pwx,
+                     flags->nthreads);
+  }
+  flags->time_shift += (realtime()-e_time);
+  (flags->transl)++;
+}
+
+/* Local-max-quadratic bound (Akritas, Strzebonski, Vigklas) on the positive
+   roots of upol, computed on the bit sizes of the coefficients: returns M
+   such that these roots are at most 2^M (LONG_MIN if there is none) */
+static long cf_lmq_bound(mpz_t *upol, const unsigned long int deg,
+                         long *used){
+  const int slc = mpz_sgn(upol[deg]);
+  long M = LONG_MIN;
+  for(unsigned long int j = 0; j <= deg; j++){
+    used[j] = 1;
+  }
+  for(unsigned long int i = 0; i < deg; i++){
+    if(mpz_sgn(upol[i]) * slc >= 0){
+      continue;
+    }
+    const long bi = ilog2(upol[i]);
+    long best = LONG_MAX;
+    unsigned long int jbest = deg;
+    for(unsigned long int j = i + 1; j <= deg; j++){
+      if(mpz_sgn(upol[j]) * slc <= 0){
+        continue;
+      }
+      /* (2^used[j] |a_i| / |a_j|)^(1/(j-i)) <= 2^e */
+      long num = used[j] + bi - (long)ilog2(upol[j]) + 1;
+      long dj = j - i;
+      long e = (num >= 0) ? (num + dj - 1) / dj : -((-num) / dj);
+      if(e < best){
+        best = e;
+        jbest = j;
+      }
+    }
+    used[jbest]++;
+    if(best > M){
+      M = best;
+    }
+  }
+  return M;
+}
+
+/* returns s such that 2^s is at most the positive roots of upol (LMQ bound
+   applied to the reciprocal polynomial), LONG_MIN if there is none */
+static long cf_lower_bound(mpz_t *upol, const unsigned long int deg,
+                           mpz_t *tmp, long *used){
+  for(unsigned long int i = 0; i <= deg; i++){
+    mpz_set(tmp[i], upol[deg - i]);
+  }
+  long M = cf_lmq_bound(tmp, deg, used);
+  if(M == LONG_MIN){
+    return LONG_MIN;
+  }
+  return -M;
+}
+
+static inline void cf_add_exact_root(cf_root *croots, unsigned long int *nbr,
+                                     mpz_t num, mpz_t den){
+  cf_root *rt = croots + (*nbr);
+  mpz_init(rt->ln);
+  mpz_init(rt->ld);
+  mpz_init(rt->rn);
+  mpz_init(rt->rd);
+  mpz_gcd(rt->ld, num, den);
+  mpz_divexact(rt->ln, num, rt->ld);
+  mpz_divexact(rt->ld, den, rt->ld);
+  mpz_set(rt->rn, rt->ln);
+  mpz_set(rt->rd, rt->ld);
+  rt->isexact = 1;
+  (*nbr)++;
+}
+
+/* records M((0, +infty)) which contains a single root */
+static inline void cf_add_interval(cf_root *croots, unsigned long int *nbr,
+                                   cf_node *node, mpz_t tmp){
+  cf_root *rt = croots + (*nbr);
+  mpz_init(rt->ln);
+  mpz_init(rt->ld);
+  mpz_init(rt->rn);
+  mpz_init(rt->rd);
+  /* M is increasing iff ad - bc > 0 */
+  mpz_mul(tmp, node->a, node->d);
+  mpz_submul(tmp, node->b, node->c);
+  if(mpz_sgn(tmp) > 0){
+    mpz_set(rt->ln, node->b);
+    mpz_set(rt->ld, node->d);
+    mpz_set(rt->rn, node->a);
+    mpz_set(rt->rd, node->c);
+  }
+  else{
+    mpz_set(rt->ln, node->a);
+    mpz_set(rt->ld, node->c);
+    mpz_set(rt->rn, node->b);
+    mpz_set(rt->rd, node->d);
+  }
+  rt->isexact = 0;
+  (*nbr)++;
+}
+
+static void cf_isolation(mpz_t *upol, const unsigned long int deg,
+                         cf_root *croots, unsigned long int *nbr,
+                         usolve_flags *flags){
+  unsigned long int nalloc = 64;
+  unsigned long int top = 0;
+  cf_node *stack = (cf_node *)malloc(sizeof(cf_node) * nalloc);
+  mpz_t *tmp = (mpz_t *)malloc(sizeof(mpz_t) * (deg + 1));
+  for(unsigned long int i = 0; i <= deg; i++){
+    mpz_init(tmp[i]);
+  }
+  long *used = (long *)malloc(sizeof(long) * (deg + 1));
+  mpz_t num, den;
+  mpz_init(num);
+  mpz_init(den);
+
+  cf_node_init(stack, upol, deg);
+  top = 1;
+
+  while(top > 0){
+    cf_node node = stack[--top];
+    (flags->node_looked)++;
+
+    if(mpz_sgn(node.pol[0]) == 0){
+      /* M(0) = b / d is a root */
+      cf_add_exact_root(croots, nbr, node.b, node.d);
+      cf_node_divide_by_x(&node);
+      if(flags->verbose >= 1){
+        fprintf(stderr, "+");
+      }
+    }
+    if(flags->hasrealroots == 1 && (*nbr) > 0){
+      cf_node_clear(&node);
+      break;
+    }
+    long nb = 0;
+    if(node.deg > 0){
+      nb = mpz_poly_sgn_variations_coeffs(node.pol, node.deg);
+    }
+    if(nb == 0){
+      cf_node_clear(&node);
+      continue;
+    }
+    if(nb == 1){
+      cf_add_interval(croots, nbr, &node, num);
+      if(flags->verbose >= 1){
+        fprintf(stderr, "+");
+      }
+      cf_node_clear(&node);
+      continue;
+    }
+
+    if(top + 2 > nalloc){
+      nalloc *= 2;
+      stack = (cf_node *)realloc(stack, sizeof(cf_node) * nalloc);
+    }
+
+    /* 2^s is at most the positive roots of node.pol */
+    long s = cf_lower_bound(node.pol, node.deg, tmp, used);
+    if(s == LONG_MIN){
+      cf_node_clear(&node);
+      continue;
+    }
+    if(s >= 0){
+      if(s >= CF_SCALE_THRESHOLD){
+        /* x -> 2^s x */
+        USOLVEmpz_poly_rescale_normalize_2exp_th(node.pol, s, node.deg,
+                                                 flags->nthreads);
+        mpz_mul_2exp(node.a, node.a, s);
+        mpz_mul_2exp(node.c, node.c, s);
+      }
+      /* x -> x + 1 */
+      cf_taylorshift1(node.pol, node.deg, flags);
+      mpz_add(node.b, node.b, node.a);
+      mpz_add(node.d, node.d, node.c);
+      stack[top++] = node;
+      continue;
+    }
+
+    /* roots in (0, 1) : x -> 1 / (x + 1) */
+    cf_node *left = stack + top;
+    cf_node_init(left, node.pol, node.deg);
+    for(unsigned long int i = 0; i < (node.deg + 1) / 2; i++){
+      mpz_swap(left->pol[i], left->pol[node.deg - i]);
+    }
+    cf_taylorshift1(left->pol, left->deg, flags);
+    mpz_set(left->a, node.b);
+    mpz_add(left->b, node.a, node.b);
+    mpz_set(left->c, node.d);
+    mpz_add(left->d, node.c, node.d);
+
+    /* roots in (1, +infty) : x -> x + 1 */
+    cf_taylorshift1(node.pol, node.deg, flags);
+    mpz_add(node.b, node.b, node.a);
+    mpz_add(node.d, node.d, node.c);
+    if(mpz_sgn(node.pol[0]) == 0){
+      /* 1 is a root of the parent node, it is recorded once */
+      cf_add_exact_root(croots, nbr, node.b, node.d);
+      cf_node_divide_by_x(&node);
+      cf_node_divide_by_x(left);
+      if(flags->verbose >= 1){
+        fprintf(stderr, "+");
+      }
+    }
+    top++;
+    stack[top++] = node;
+  }
+
+  while(top > 0){
+    cf_node_clear(stack + (--top));
+  }
+  free(stack);
+  for(unsigned long int i = 0; i <= deg; i++){
+    mpz_clear(tmp[i]);
+  }
+  free(tmp);
+  free(used);
+  mpz_clear(num);
+  mpz_clear(den);
+}
+
+/* sign of (an / ad) - (bn / bd) with ad, bd > 0 */
+static inline int cf_cmp_rat(mpz_t an, mpz_t ad, mpz_t bn, mpz_t bd,
+                             mpz_t t1, mpz_t t2){
+  mpz_mul(t1, an, bd);
+  mpz_mul(t2, bn, ad);
+  return mpz_cmp(t1, t2);
+}
+
+static int cf_root_cmp(const void *a, const void *b){
+  const cf_root *ra = (const cf_root *)a;
+  const cf_root *rb = (const cf_root *)b;
+  mpz_t t1, t2;
+  mpz_init(t1);
+  mpz_init(t2);
+  mpz_mul(t1, ra->ln, rb->ld);
+  mpz_mul(t2, rb->ln, ra->ld);
+  int c = mpz_cmp(t1, t2);
+  mpz_clear(t1);
+  mpz_clear(t2);
+  if(c == 0){
+    /* an exact root comes before the interval it is the left end of */
+    c = (int)rb->isexact - (int)ra->isexact;
+  }
+  return c;
+}
+
+/* computes a dyadic interval (numer / 2^k, (numer + 1) / 2^k) contained in
+   the open interval (ln / ld, rn / rd) and containing its unique root, or this
+   root when it is dyadic ; returns the sign of upol at the left end */
+static int cf_interval_to_dyadic(mpz_t *upol, const unsigned long int deg,
+                                 cf_root *crt, interval *rt,
+                                 mpz_t *tmp){
+  mpz_t *A = tmp, *B = tmp + 1, *M = tmp + 2, *t = tmp + 3;
+  /* 2^(-k) is about a quarter of the width of the interval */
+  mpz_mul(*t, crt->rn, crt->ld);
+  mpz_submul(*t, crt->ln, crt->rd);
+  mpz_mul(*M, crt->ld, crt->rd);
+  long k = MAX(0, (long)ilog2(*M) - (long)ilog2(*t) + 2);
+  rt->isexact = 0;
+
+  while(1){
+    /* smallest (resp. largest) point of the grid 2^(-k) Z greater (resp.
+       smaller) than the left (resp. right) end */
+    mpz_mul_2exp(*A, crt->ln, k);
+    mpz_fdiv_q(*A, *A, crt->ld);
+    mpz_add_ui(*A, *A, 1);
+    mpz_mul_2exp(*B, crt->rn, k);
+    mpz_cdiv_q(*B, *B, crt->rd);
+    mpz_sub_ui(*B, *B, 1);
+    if(mpz_cmp(*A, *B) <= 0){
+      int sA = sgn_mpz_poly_eval_at_point_2exp_naive(upol, deg, A, k);
+      if(sA == 0){
+        mpz_set(rt->numer, *A);
+        rt->k = k;
+        rt->isexact = 1;
+        return 0;
+      }
+      int sB = sgn_mpz_poly_eval_at_point_2exp_naive(upol, deg, B, k);
+      if(sB == 0){
+        mpz_set(rt->numer, *B);
+        rt->k = k;
+        rt->isexact = 1;
+        return 0;
+      }
+      if(sA * sB < 0){
+        mpz_sub(*t, *B, *A);
+        while(mpz_cmp_ui(*t, 1) > 0){
+          mpz_add(*M, *A, *B);
+          mpz_fdiv_q_2exp(*M, *M, 1);
+          int sM = sgn_mpz_poly_eval_at_point_2exp_naive(upol, deg, M, k);
+          if(sM == 0){
+            mpz_set(rt->numer, *M);
+            rt->k = k;
+            rt->isexact = 1;
+            return 0;
+          }
+          if(sM == sA){
+            mpz_set(*A, *M);
+          }
+          else{
+            mpz_set(*B, *M);
+          }
+          mpz_sub(*t, *B, *A);
+        }
+        mpz_set(rt->numer, *A);
+        rt->k = k;
+        return sA;
+      }
+    }
+    k++;
+  }
+}
+
+/* computes a dyadic interval containing the non-dyadic rational root
+   crt->ln / crt->ld, whose left (resp. right) end is greater (resp. less) than
+   lb = lbn / lbd (resp. ub = ubn / ubd) ; equality is allowed when lstrict
+   (resp. ustrict) is 0. Returns the sign of upol at the left end. */
+static int cf_rational_root_to_dyadic(mpz_t *upol, const unsigned long int deg,
+                                      cf_root *crt, interval *rt,
+                                      mpz_t lbn, mpz_t lbd, const int lstrict,
+                                      mpz_t ubn, mpz_t ubd, const int ustrict,
+                                      mpz_t *tmp){
+  mpz_t *A = tmp, *B = tmp + 1, *P = tmp + 2, *t1 = tmp + 3, *t2 = tmp + 4;
+  long k = 0;
+  while(1){
+    mpz_mul_2exp(*A, crt->ln, k);
+    mpz_fdiv_q(*A, *A, crt->ld);
+    mpz_add_ui(*B, *A, 1);
+    mpz_set_ui(*P, 1);
+    mpz_mul_2exp(*P, *P, k);
+    int cl = cf_cmp_rat(*A, *P, lbn, lbd, *t1, *t2);
+    int cu = cf_cmp_rat(*B, *P, ubn, ubd, *t1, *t2);
+    if((cl > 0 || (cl == 0 && !lstrict)) && (cu < 0 || (cu == 0 && !ustrict))){
+      mpz_set(rt->numer, *A);
+      rt->k = k;
+      rt->isexact = 0;
+      return sgn_mpz_poly_eval_at_point_2exp_naive(upol, deg, A, k);
+    }
+    k++;
+  }
+}
+
+/* turns the roots isolated by cf_isolation into dyadic intervals stored in
+   roots as bisection_rec does ; bound is such that the roots are less than
+   2^bound */
+static void cf_to_dyadic(mpz_t *upol, const unsigned long int deg,
+                         cf_root *croots, const unsigned long int nb,
+                         const long bound,
+                         interval *roots, unsigned long int *nbr,
+                         usolve_flags *flags){
+  qsort(croots, nb, sizeof(cf_root), cf_root_cmp);
+
+  interval *drts = (interval *)malloc(sizeof(interval) * nb);
+  int *sgns = (int *)malloc(sizeof(int) * nb);
+  /* 1 when the root is a non dyadic rational number */
+  int *pending = (int *)calloc(nb, sizeof(int));
+  mpz_t *tmp = (mpz_t *)malloc(sizeof(mpz_t) * 5);
+  for(int i = 0; i < 5; i++){
+    mpz_init(tmp[i]);
+  }
+  mpz_t lbn, lbd, ubn, ubd;
+  mpz_init(lbn);
+  mpz_init(lbd);
+  mpz_init(ubn);
+  mpz_init(ubd);
+
+  for(unsigned long int i = 0; i < nb; i++){
+    cf_root *crt = croots + i;
+    mpz_init(drts[i].numer);
+    sgns[i] = 0;
+    if(crt->isexact){
+      /* ln/ld is reduced by cf_add_exact_root */
+      if(mpz_popcount(crt->ld) == 1){
+        mpz_set(drts[i].numer, crt->ln);
+        drts[i].k = mpz_scan1(crt->ld, 0);
+        drts[i].isexact = 1;
+      }
+      else{
+        pending[i] = 1;
+      }
+      continue;
+    }
+    if(mpz_sgn(crt->rd) == 0){
+      mpz_set_ui(crt->rn, 1);
+      mpz_mul_2exp(crt->rn, crt->rn, MAX(bound, 0));
+      mpz_set_ui(crt->rd, 1);
+    }
+    sgns[i] = cf_interval_to_dyadic(upol, deg, crt, drts + i, tmp);
+  }
+
+  for(unsigned long int i = 0; i < nb; i++){
+    if(!pending[i]){
+      continue;
+    }
+    int lstrict = 1, ustrict = 0;
+    if(i == 0){
+      mpz_set_ui(lbn, 0);
+      mpz_set_ui(lbd, 1);
+    }
+    else{
+      interval *prt = drts + i - 1;
+      lstrict = (prt->isexact == 1);
+      if(prt->isexact == 1){
+        mpz_set(lbn, prt->numer);
+      }
+      else{
+        mpz_add_ui(lbn, prt->numer, 1);
+      }
+      mpz_set_ui(lbd, 1);
+      mpz_mul_2exp(lbd, lbd, prt->k);
+    }
+    if(i == nb - 1){
+      mpz_set_ui(ubn, 1);
+      mpz_mul_2exp(ubn, ubn, MAX(bound, 0));
+      mpz_set_ui(ubd, 1);
+    }
+    else if(pending[i + 1]){
+      ustrict = 1;
+      mpz_set(ubn, croots[i + 1].ln);
+      mpz_set(ubd, croots[i + 1].ld);
+    }
+    else{
+      interval *nrt = drts + i + 1;
+      ustrict = (nrt->isexact == 1);
+      mpz_set(ubn, nrt->numer);
+      mpz_set_ui(ubd, 1);
+      mpz_mul_2exp(ubd, ubd, nrt->k);
+    }
+    sgns[i] = cf_rational_root_to_dyadic(upol, deg, croots + i, drts + i,
+                                         lbn, lbd, lstrict, ubn, ubd, ustrict,
+                                         tmp);
+    pending[i] = 0;
+  }
+
+  for(unsigned long int i = 0; i < nb; i++){
+    merge_root(roots, drts[i].numer, drts[i].k, drts[i].isexact, sgns[i],
+               *nbr, 0, 0, flags->sign);
+    (*nbr)++;
+    mpz_clear(drts[i].numer);
+    mpz_clear(croots[i].ln);
+    mpz_clear(croots[i].ld);
+    mpz_clear(croots[i].rn);
+    mpz_clear(croots[i].rd);
+  }
+
+  for(int i = 0; i < 5; i++){
+    mpz_clear(tmp[i]);
+  }
+  free(tmp);
+  mpz_clear(lbn);
+  mpz_clear(lbd);
+  mpz_clear(ubn);
+  mpz_clear(ubd);
+  free(drts);
+  free(sgns);
+  free(pending);
+}
+
+/* isolates the positive roots of upol by continued fractions (see
+   cf_isolation) ; roots are stored as bisection_rec does */
+static void continued_fraction_isolation(mpz_t *upol, const unsigned long int deg,
+                                         const long bound,
+                                         interval *roots, unsigned long int *nbr,
+                                         usolve_flags *flags){
+  cf_root *croots = (cf_root *)malloc(sizeof(cf_root) * (deg + 1));
+  unsigned long int nb = 0;
+  cf_isolation(upol, deg, croots, &nb, flags);
+  cf_to_dyadic(upol, deg, croots, nb, bound, roots, nbr, flags);
+  free(croots);
+}
+
+/* decides whether the positive roots of upol are isolated with continued
+   fractions ; bound is such that these roots are less than 2^bound */
+static int use_continued_fractions(mpz_t *upol, const unsigned long int deg,
+                                   const long bound, usolve_flags *flags){
+  if(flags->cf_algo != 2){
+    return flags->cf_algo;
+  }
+  mpz_t *tmp = (mpz_t *)malloc(sizeof(mpz_t) * (deg + 1));
+  for(unsigned long int i = 0; i <= deg; i++){
+    mpz_init(tmp[i]);
+  }
+  long *used = (long *)malloc(sizeof(long) * (deg + 1));
+  long lbound = cf_lower_bound(upol, deg, tmp, used);
+  for(unsigned long int i = 0; i <= deg; i++){
+    mpz_clear(tmp[i]);
+  }
+  free(tmp);
+  free(used);
+  if(lbound == LONG_MIN){
+    return 0;
+  }
+  return (bound - lbound > CF_SPREAD_THRESHOLD);
+}
+
 /* warning: does not check that upol is square-free (should be done outside) */
 
 interval *bisection_Uspensky(mpz_t *upol0, unsigned long deg,
@@ -1152,20 +1727,34 @@ interval *bisection_Uspensky(mpz_t *upol0, unsigned long deg,
       fprintf(stderr, "Bound for positive roots: %ld\n\n", flags->bound_pos);
     }
 
-    USOLVEmpz_poly_rescale_normalize_2exp_th(upol,
-                                             flags->bound_pos, deg,
-                                             flags->nthreads);
-    initialize_heap_flags(flags, deg);
-
-    unsigned olddeg = deg;
-    bisection_rec(upol, &deg, e, 0,
-                  pos_roots, nb_pos_roots,
-                  flags, tmp_half);
-    nb_positive_roots = *nb_pos_roots;
-
-    free_heap_flags(flags, olddeg);
-    unallocate_shift_pwx(flags->shift_pwx,
-                         flags->npwr, flags->pwx);
+    if(use_continued_fractions(upol, deg, flags->bound_pos, flags)){
+      if(flags->verbose>=1){
+        fprintf(stderr, "Isolation by continued fractions\n");
+      }
+      initialize_heap_flags(flags, deg);
+      continued_fraction_isolation(upol, deg, flags->bound_pos,
+                                   pos_roots, nb_pos_roots, flags);
+      nb_positive_roots = *nb_pos_roots;
+      free_heap_flags(flags, deg);
+      unallocate_shift_pwx(flags->shift_pwx,
+                           flags->npwr, flags->pwx);
+    }
+    else{
+      USOLVEmpz_poly_rescale_normalize_2exp_th(upol,
+                                               flags->bound_pos, deg,
+                                               flags->nthreads);
+      initialize_heap_flags(flags, deg);
+
+      unsigned olddeg = deg;
+      bisection_rec(upol, &deg, e, 0,
+                    pos_roots, nb_pos_roots,
+                    flags, tmp_half);
+      nb_positive_roots = *nb_pos_roots;
+
+      free_heap_flags(flags, olddeg);
+      unallocate_shift_pwx(flags->shift_pwx,
+                           flags->npwr, flags->pwx);
+    }
   }
 
   /* replaces upol(x) by upol(-x) => negative roots */
@@ -1201,26 +1790,41 @@ interval *bisection_Uspensky(mpz_t *upol0, unsigned long deg,
 
     flags->bound_neg = bound_roots(upol, deg);
 
-    USOLVEmpz_poly_rescale_normalize_2exp_th(upol,
-                                             flags->bound_neg, deg,
-                                             flags->nthreads);
-
     if(flags->verbose>=1){
       fprintf(stderr, "\nBound for negative roots: %ld\n\n", flags->bound_neg);
     }
 
-    mpz_set_ui(e, 0);
     flags->sign = 1;
 
-    initialize_heap_flags(flags, deg);
-    unsigned long int olddeg = deg;
-    bisection_rec(upol, &deg, e, 0,
-                  neg_roots, nb_neg_roots,
-                  flags, tmp_half);
-    nb_negative_roots = (*nb_neg_roots);
-    free_heap_flags(flags, olddeg);
-    unallocate_shift_pwx(flags->shift_pwx,
-                         flags->npwr, flags->pwx);
+    if(use_continued_fractions(upol, deg, flags->bound_neg, flags)){
+      if(flags->verbose>=1){
+        fprintf(stderr, "Isolation by continued fractions\n");
+      }
+      initialize_heap_flags(flags, deg);
+      continued_fraction_isolation(upol, deg, flags->bound_neg,
+                                   neg_roots, nb_neg_roots, flags);
+      nb_negative_roots = (*nb_neg_roots);
+      free_heap_flags(flags, deg);
+      unallocate_shift_pwx(flags->shift_pwx,
+                           flags->npwr, flags->pwx);
+    }
+    else{
+      USOLVEmpz_poly_rescale_normalize_2exp_th(upol,
+                                               flags->bound_neg, deg,
+                                               flags->nthreads);
+
+      mpz_set_ui(e, 0);
+
+      initialize_heap_flags(flags, deg);
+      unsigned long int olddeg = deg;
+      bisection_rec(upol, &deg, e, 0,
+                    neg_roots, nb_neg_roots,
+                    flags, tmp_half);
+      nb_negative_roots = (*nb_neg_roots);
+      free_heap_flags(flags, olddeg);
+      unallocate_shift_pwx(flags->shift_pwx,
+                           flags->npwr, flags->pwx);
+    }
   }
 
   unsigned long int nbroots = nb_positive_roots + nb_negative_roots;
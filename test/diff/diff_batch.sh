@@ -0,0 +1,42 @@
+#!/bin/bash
+
+# both inputs have the same support but different coefficients
+file=kat7-qq
+file2=kat7-2-qq
+
+# reference output of the second instance from a single run
+$(pwd)/msolve -f input_files/$file2.ms -o test/diff/$file2.res -P 2
+if [ $? -gt 0 ]; then
+    exit 1
+fi
+
+printf "input_files/$file.ms test/diff/$file.1.res\n\
+input_files/$file2.ms test/diff/$file2.1.res\n" > test/diff/$file.batch
+$(pwd)/msolve -b test/diff/$file.batch -P 2 -v 1 2> test/diff/$file.log
+if [ $? -gt 0 ]; then
+    exit 2
+fi
+
+diff test/diff/$file.1.res output_files/$file.res
+if [ $? -gt 0 ]; then
+    exit 3
+fi
+
+diff test/diff/$file2.1.res test/diff/$file2.res
+if [ $? -gt 0 ]; then
+    exit 4
+fi
+
+# the second instance reuses the tracer and the staircase of the first one
+if [ $(grep -c "Tracer of previous batch instance reused" \
+    test/diff/$file.log) -ne 1 ]; then
+    exit 5
+fi
+
+if [ $(grep -c "Staircase of previous batch instance reused" \
+    test/diff/$file.log) -ne 1 ]; then
+    exit 6
+fi
+
+rm test/diff/$file.1.res test/diff/$file2.1.res test/diff/$file2.res
+rm test/diff/$file.batch test/diff/$file.log
@@ -0,0 +1,27 @@
+#!/bin/bash
+
+# the eliminating polynomial (x^2-2)^2*(x-3) has roots of multiplicity 2,
+# the denominator vanishes close to sqrt(2) so that this root is refined
+# further during the extraction of the real roots
+file=mult_roots
+
+for x in 1 2; do
+    $(pwd)/msolve -I 1 -x $x -f input_files/$file.param \
+        -o test/diff/$file.$x.res
+    if [ $? -gt 0 ]; then
+        exit $x
+    fi
+done
+
+# both options split the polynomial into the same factors
+diff test/diff/$file.1.res test/diff/$file.2.res
+if [ $? -gt 0 ]; then
+    exit 3
+fi
+
+# three real roots, each one given by two intervals of two bounds
+if [ $(grep -o "2^" test/diff/$file.1.res | wc -l) -ne 12 ]; then
+    exit 4
+fi
+
+rm test/diff/$file.1.res test/diff/$file.2.res
@@ -0,0 +1,26 @@
+#!/bin/bash
+
+# later primes of the trace based computation in shape position get the
+# eliminating polynomial from the Hankel matrix instead of Berlekamp-Massey
+
+for file in kat7-qq radical_shape-qq; do
+
+    $(pwd)/msolve -f input_files/$file.ms -o test/diff/$file.res -P 2 -t 2 -v 2 \
+        2> test/diff/$file.log
+    if [ $? -gt 0 ]; then
+        exit 1
+    fi
+
+    grep -q "Eliminating polynomial obtained from the Hankel matrix" test/diff/$file.log
+    if [ $? -gt 0 ]; then
+        exit 2
+    fi
+
+    diff test/diff/$file.res output_files/$file.res
+    if [ $? -gt 0 ]; then
+        exit 3
+    fi
+
+    rm test/diff/$file.res test/diff/$file.log
+
+done
@@ -0,0 +1,51 @@
+#!/bin/bash
+
+# Groebner bases over the rationals lifted from 62 bit primes (-B 62)
+
+file=one-qq
+
+$(pwd)/msolve -f input_files/$file.ms -o test/diff/$file.res -g 2 -B 62
+if [ $? -gt 0 ]; then
+    exit 1
+fi
+
+diff test/diff/$file.res output_files/$file.g2.res
+if [ $? -gt 0 ]; then
+    exit 2
+fi
+
+rm test/diff/$file.res
+
+file=elim-qq
+
+$(pwd)/msolve -f input_files/$file.ms -o test/diff/$file.res -e 1 -g 2 -B 62
+if [ $? -gt 0 ]; then
+    exit 3
+fi
+
+diff test/diff/$file.res output_files/$file.res
+if [ $? -gt 0 ]; then
+    exit 4
+fi
+
+rm test/diff/$file.res
+
+# same basis as with 31 bit primes
+file=radical_shape-qq
+
+$(pwd)/msolve -f input_files/$file.ms -o test/diff/$file.31.res -g 2
+if [ $? -gt 0 ]; then
+    exit 5
+fi
+
+$(pwd)/msolve -f input_files/$file.ms -o test/diff/$file.62.res -g 2 -B 62
+if [ $? -gt 0 ]; then
+    exit 6
+fi
+
+diff test/diff/$file.31.res test/diff/$file.62.res
+if [ $? -gt 0 ]; then
+    exit 7
+fi
+
+rm test/diff/$file.31.res test/diff/$file.62.res
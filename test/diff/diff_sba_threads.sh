@@ -0,0 +1,22 @@
+#!/bin/bash
+
+# signature based Groebner basis of the homogenized katsura-6 system, the
+# matrices are reduced by blocks of signature ordered rows in parallel
+file=kat6-h-31
+
+$(pwd)/msolve -q 1 -g 2 -t 1 -f input_files/$file.ms -o test/diff/$file.1.res
+if [ $? -gt 0 ]; then
+    exit 1
+fi
+
+$(pwd)/msolve -q 1 -g 2 -t 4 -f input_files/$file.ms -o test/diff/$file.4.res
+if [ $? -gt 0 ]; then
+    exit 2
+fi
+
+diff test/diff/$file.1.res test/diff/$file.4.res
+if [ $? -gt 0 ]; then
+    exit 3
+fi
+
+rm test/diff/$file.1.res test/diff/$file.4.res
@@ -0,0 +1,55 @@
+#!/bin/bash
+
+# stream of 302 polynomials: the zero and a constant polynomial, then
+# (x^2-i)^2*(x+i) for i = 1..300, which has two real roots for i = 1 and
+# three for i > 1. The batch size depends on the number of threads, the
+# stream is split into 5, 3 and 2 batches with -t 1, 2 and 4.
+file=stream
+
+for t in 1 2 4; do
+    $(pwd)/msolve -I 2 -t $t -f input_files/$file.upol \
+        -o test/diff/$file.$t.res
+    if [ $? -gt 0 ]; then
+        exit 1
+    fi
+done
+
+# same stream read from the standard input
+cat input_files/$file.upol | $(pwd)/msolve -I 2 -t 2 -f - > test/diff/$file.in.res
+if [ $? -gt 0 ]; then
+    exit 1
+fi
+
+for r in 2 4 in; do
+    diff test/diff/$file.1.res test/diff/$file.$r.res
+    if [ $? -gt 0 ]; then
+        exit 2
+    fi
+done
+
+# splitting the polynomials does not depend on the number of threads and
+# both options give the same factors
+for x in 1 2; do
+    $(pwd)/msolve -I 2 -x $x -t $x -f input_files/$file.upol \
+        -o test/diff/$file.x$x.res
+    if [ $? -gt 0 ]; then
+        exit 3
+    fi
+done
+
+diff test/diff/$file.x1.res test/diff/$file.x2.res
+if [ $? -gt 0 ]; then
+    exit 4
+fi
+
+# one line per polynomial, each root is opened by one bracket
+for r in 1 x1; do
+    awk '{n = gsub(/\[/, "["); e = (NR <= 3 ? NR == 3 ? 3 : 1 : 4);
+          if(n != e) bad = 1} END{exit (bad || NR != 302)}' \
+        test/diff/$file.$r.res
+    if [ $? -gt 0 ]; then
+        exit 5
+    fi
+done
+
+rm test/diff/$file.*.res
@@ -0,0 +1,67 @@
+#!/bin/bash
+
+file=kat7-qq
+tracer=test/diff/$file.tr
+
+rm -f $tracer
+
+# first run learns the tracer and stores it in the tracer file
+$(pwd)/msolve -f input_files/$file.ms -o test/diff/$file.res -P 2 -T $tracer \
+    -v 1 2> test/diff/$file.log
+if [ $? -gt 0 ]; then
+    exit 1
+fi
+
+diff test/diff/$file.res output_files/$file.res
+if [ $? -gt 0 ]; then
+    exit 2
+fi
+
+grep -q "Tracer written to" test/diff/$file.log
+if [ $? -gt 0 ]; then
+    exit 3
+fi
+
+# second run reads the tracer from the tracer file
+$(pwd)/msolve -f input_files/$file.ms -o test/diff/$file.res -P 2 -T $tracer \
+    -v 1 2> test/diff/$file.log
+if [ $? -gt 0 ]; then
+    exit 4
+fi
+
+diff test/diff/$file.res output_files/$file.res
+if [ $? -gt 0 ]; then
+    exit 5
+fi
+
+# the learning phase must have been skipped
+grep -q "Tracer read from" test/diff/$file.log
+if [ $? -gt 0 ]; then
+    exit 6
+fi
+
+# batch mode, both instances read the tracer from the tracer file
+printf "input_files/$file.ms test/diff/$file.1.res\n\
+input_files/$file.ms test/diff/$file.2.res\n" > test/diff/$file.batch
+$(pwd)/msolve -b test/diff/$file.batch -P 2 -T $tracer -v 1 \
+    2> test/diff/$file.log
+if [ $? -gt 0 ]; then
+    exit 7
+fi
+
+diff test/diff/$file.1.res output_files/$file.res
+if [ $? -gt 0 ]; then
+    exit 8
+fi
+
+diff test/diff/$file.2.res output_files/$file.res
+if [ $? -gt 0 ]; then
+    exit 9
+fi
+
+if [ $(grep -c "Tracer read from" test/diff/$file.log) -ne 2 ]; then
+    exit 10
+fi
+
+rm test/diff/$file.res test/diff/$file.1.res test/diff/$file.2.res
+rm test/diff/$file.batch test/diff/$file.log $tracer
@@ -23,7 +23,7 @@ int main(void)
     int32_t precision             = 128;
     int32_t refine                = 0; /* not used at the moment */
     int32_t isolate               = 0; /* not used at the moment */
-    files_gb *files = malloc(sizeof(files_gb));
+    files_gb *files = calloc(1, sizeof(files_gb));
     files->in_file  = "input_files/nonradical_radicalshape-31.ms";
     files->out_file  = NULL;
     FILE *fh  = fopen(files->in_file, "r");
@@ -34,7 +34,7 @@ int main(void)
     int32_t nr_gens     = 0;
     data_gens_ff_t *gens = allocate_data_gens();
 
-    get_data_from_file(files->in_file, &nr_vars, &field_char,&nr_gens,gens);
+    get_data_from_file(files->in_file, &nr_vars, &field_char,&nr_gens,gens,nr_threads);
 
     if (nr_vars != 2) return 101;
     if (field_char != 1073741827) return 102;
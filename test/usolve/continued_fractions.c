@@ -0,0 +1,187 @@
+/* This file is part of msolve.
+ *
+ * msolve is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * msolve is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with msolve.  If not, see <https://www.gnu.org/licenses/>
+ *
+ * Authors:
+ * Jérémy Berthomieu
+ * Christian Eder
+ * Mohab Safey El Din */
+
+#include "../../src/usolve/usolve.c"
+
+/* isolates the real roots of pol with bisection (cf_algo = 0), continued
+ * fractions (cf_algo = 1) or the automatic choice (cf_algo = 2) */
+static interval *isolate(mpz_t *pol, unsigned long int deg,
+                         unsigned long int *nbpos, unsigned long int *nbneg,
+                         const unsigned int cf_algo){
+  usolve_flags *flags = (usolve_flags*)(malloc(sizeof(usolve_flags)));
+  initialize_flags(flags);
+  flags->cur_deg = deg;
+  flags->cf_algo = cf_algo;
+  interval *roots = bisection_Uspensky(pol, deg, nbpos, nbneg, flags);
+  free(flags);
+  return roots;
+}
+
+/* end points of the isolating interval rt, see refine_root_naive */
+static void interval_bounds(mpq_t lo, mpq_t hi, interval *rt){
+  mpq_set_z(lo, rt->numer);
+  if(rt->k >= 0){
+    mpq_div_2exp(lo, lo, rt->k);
+  }
+  mpq_set(hi, lo);
+  if(rt->isexact != 1){
+    mpq_t w;
+    mpq_init(w);
+    mpq_set_ui(w, 1, 1);
+    if(rt->k >= 0){
+      mpq_div_2exp(w, w, rt->k);
+    }
+    else{
+      mpq_mul_2exp(w, w, -rt->k);
+    }
+    mpq_add(hi, hi, w);
+    mpq_clear(w);
+  }
+}
+
+/* the isolating intervals of both methods must meet pairwise and isolate
+ * the same exact roots */
+static int compare_roots(interval *r1, interval *r2, unsigned long int nb){
+  int ret = 0;
+  mpq_t lo1, hi1, lo2, hi2;
+  mpq_inits(lo1, hi1, lo2, hi2, NULL);
+  for(unsigned long int i = 0; i < nb; i++){
+    interval_bounds(lo1, hi1, r1 + i);
+    interval_bounds(lo2, hi2, r2 + i);
+    if(mpq_cmp(lo1, hi2) > 0 || mpq_cmp(lo2, hi1) > 0){
+      ret = 1;
+    }
+    if(r1[i].isexact == 1 && r2[i].isexact == 1 && !mpq_equal(lo1, lo2)){
+      ret = 1;
+    }
+  }
+  mpq_clears(lo1, hi1, lo2, hi2, NULL);
+  return ret;
+}
+
+/* multiplies pol of degree deg by a x + b */
+static void mul_linear(mpz_t *pol, unsigned long int deg,
+                       const mpz_t a, const mpz_t b){
+  mpz_mul(pol[deg + 1], pol[deg], a);
+  for(long i = deg; i > 0; i--){
+    mpz_mul(pol[i], pol[i], b);
+    mpz_addmul(pol[i], pol[i - 1], a);
+  }
+  mpz_mul(pol[0], pol[0], b);
+}
+
+int main(void){
+  /* linear factors a x + b given by (a, log2(a), b, log2(b)) ; when the
+   * log2 entries are not zero, a (resp. b) is replaced by 2^log2 */
+  const long lins[4][6][4] = {
+    /* rational roots, dyadic or not */
+    {{1, 0, -1, 0}, {1, 0, -2, 0}, {1, 0, 3, 0},
+     {2, 0, -1, 0}, {3, 0, -1, 0}, {7, 0, 5, 0}},
+    /* roots of very different sizes */
+    {{0, 80, -1, 0}, {1, 0, 0, 80}, {1, 0, 5, 0},
+     {3, 0, -1, 0}, {0, 40, 1, 0}, {1, 0, -3, 0}},
+    /* close roots */
+    {{1000, 0, -1001, 0}, {1001, 0, -1002, 0}, {1002, 0, -1003, 0},
+     {1, 0, 1, 0}, {5, 0, -3, 0}, {1, 0, 0, 0}},
+    /* zero is a root */
+    {{1, 0, 0, 0}, {9, 0, -2, 0}, {9, 0, 2, 0},
+     {4, 0, -3, 0}, {0, 20, -3, 0}, {1, 0, 0, 30}},
+  };
+  const unsigned long int nlins = 6;
+  /* each product is multiplied by x^2 - 2 and x^2 + 1 */
+  const unsigned long int deg = nlins + 4;
+
+  mpz_t *pol = malloc(sizeof(mpz_t) * (deg + 1));
+  for(unsigned long int i = 0; i <= deg; i++){
+    mpz_init(pol[i]);
+  }
+  mpz_t a, b;
+  mpz_init(a);
+  mpz_init(b);
+  for(int t = 0; t < 4; t++){
+    mpz_set_ui(pol[0], 1);
+    for(unsigned long int i = 1; i <= deg; i++){
+      mpz_set_ui(pol[i], 0);
+    }
+    unsigned long int d = 0;
+    for(unsigned long int j = 0; j < nlins; j++){
+      mpz_set_si(a, lins[t][j][0]);
+      if(lins[t][j][1]){
+        mpz_set_ui(a, 1);
+        mpz_mul_2exp(a, a, lins[t][j][1]);
+      }
+      mpz_set_si(b, lins[t][j][2]);
+      if(lins[t][j][3]){
+        mpz_set_si(b, -1);
+        mpz_mul_2exp(b, b, lins[t][j][3]);
+      }
+      mul_linear(pol, d, a, b);
+      d++;
+    }
+    /* x^2 - 2 = (x - 2^(1/2)) (x + 2^(1/2)) and x^2 + 1 */
+    for(int j = 0; j < 2; j++){
+      for(long i = d; i >= 0; i--){
+        mpz_set(pol[i + 2], pol[i]);
+      }
+      mpz_set_ui(pol[1], 0);
+      mpz_set_ui(pol[0], 0);
+      for(unsigned long int i = 0; i <= d; i++){
+        if(j == 0){
+          mpz_submul_ui(pol[i], pol[i + 2], 2);
+        }
+        else{
+          mpz_add(pol[i], pol[i], pol[i + 2]);
+        }
+      }
+      d += 2;
+    }
+
+    unsigned long int np[3], nn[3];
+    interval *roots[3];
+    for(unsigned int c = 0; c < 3; c++){
+      roots[c] = isolate(pol, deg, np + c, nn + c, c);
+    }
+    for(unsigned int c = 1; c < 3; c++){
+      if(np[c] != np[0] || nn[c] != nn[0]){
+        return 10 * t + c;
+      }
+      if(compare_roots(roots[0], roots[c], np[0] + nn[0])){
+        return 10 * t + 2 + c;
+      }
+    }
+    /* all linear factors and x^2 - 2 have real roots */
+    if(np[0] + nn[0] != nlins + 2){
+      return 10 * t + 5;
+    }
+    for(unsigned int c = 0; c < 3; c++){
+      for(unsigned long int i = 0; i < np[c] + nn[c]; i++){
+        mpz_clear(roots[c][i].numer);
+      }
+      free(roots[c]);
+    }
+  }
+  for(unsigned long int i = 0; i <= deg; i++){
+    mpz_clear(pol[i]);
+  }
+  free(pol);
+  mpz_clear(a);
+  mpz_clear(b);
+  return 0;
+}